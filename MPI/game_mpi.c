@@ -1,7 +1,7 @@
 /* File:    game_mpi.c
  * Purpose: Run the Game of Life on multiple processes using MPI.
  * Compile: mpicc -o game_mpi game_mpi.c -std=gnu99
- * Run:     mpirun -np <number of processes> game_mpi  <board size> <generations>
+ * Run:     mpirun -np <number of processes> game_mpi <board size> <generations> [seed] [pattern.rle] [--checkpoint interval file] [--restore file] [--print interval prefix] [--stats n] [--verify]
  * Input:   None
  * Output:  Resultant generation, number of alive cells, and time spent doing calculations.
  *
@@ -9,14 +9,28 @@
  *  1.  Time given in seconds.
  *  2.  Limited number of processes allowed.
  *  3.  The bigger the grid, the bigger the space required in memory.
+ *  4.  The board is decomposed into a 2D grid of tiles (MPI_Cart_create), so
+ *      each rank exchanges O(size/sqrt(nprocs)) halo cells per step instead
+ *      of whole board rows. Column splits are rounded to byte boundaries so
+ *      every rank's rows of the packed snapshot stay disjoint for MPI-IO.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <sys/time.h>
 #include <mpi.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../rle.h"
+#include "../checkpoint.h"
+#include "../prand.h"
+#include "../hugealloc.h"
+
 // Cell definitions (must be integers and char*)
 #define ALIVE 		1
 #define DEAD		0
@@ -36,24 +50,44 @@ twoD_array_t	*build_array(twoD_array_t * a, int rows, int cols);
 void			free_array(twoD_array_t * a);
 int				read_board(FILE* infile, twoD_array_t *board);
 int				random_board(int size, int seed, twoD_array_t *board);
-void			update_board(twoD_array_t *board, twoD_array_t *new_board);
-void			print_board(FILE* outfile, twoD_array_t *board);
+int				rle_board(const char *path, int size, twoD_array_t *board);
+int				checkpoint_board_mpi(const char *path, twoD_array_t *board, int size, int generation);
+int				restore_board_mpi(const char *path, int size, twoD_array_t *board, int *generation, long long *local_alive);
+long long		update_board(twoD_array_t *board, twoD_array_t *new_board);
 void			clear_border(twoD_array_t *board);
-int				rows_per_process(int size);
-int				local_rows(int proc_id, int size);
-int				local_start_row(int proc_id, int size);
-int				local_end_row(int proc_id, int size);
-int				process_owning_row(int row, int size);
+int				local_rows(int row_coord, int size);
+int				local_start_row(int row_coord, int size);
+int				local_end_row(int row_coord, int size);
+int				local_cols(int col_coord, int size);
+int				local_start_col(int col_coord, int size);
+int				local_end_col(int col_coord, int size);
 double			get_time();
 
 // Global variables
 int nprocs;
 int myid;
 
+// 2D Cartesian decomposition: each rank owns a tile of the board
+int				dims[2],
+				coords[2],
+				north,
+				south,
+				west,
+				east;
+MPI_Comm		cart_comm;
+
+// One ghost-height column of the local tile (strided through the rows)
+MPI_Datatype	column_type;
+
+// Per-rank halo-exchange and compute seconds in the current stats
+// window (--stats); update_board only accumulates them when enabled
+int				stats_interval = 0;
+double			halo_secs = 0.0,
+				comp_secs = 0.0;
+
 // Message tags
 #define INITIALIZE_TAG	1
 #define EXCHANGE_TAG	2
-#define PRINT_TAG		3
 
 // Main function
 int main( int argc, char* argv[] )
@@ -70,14 +104,22 @@ int main( int argc, char* argv[] )
 	twoD_array_t	*board = &board1;
 	twoD_array_t	*new_board = &board2;
 
+	long long		local_alive = 0,
+					total_alive = 0;
+
 	double			start_time_serial,
 					start_time_parallel,
-					end_time;
+					end_time,
+					stats_last_time = 0.0;
 
-	char			*usage_fmt = "Invalid arguments!\n\nUsage: mpirun -np <number of processes> %s <board size> <generations>\n\n",
+	char			*usage_fmt = "Invalid arguments!\n\nUsage: mpirun -np <number of processes> %s <board size> <generations> [seed] [pattern.rle] [--checkpoint interval file] [--restore file] [--print interval prefix] [--stats n] [--verify]\n\n\tseed - random seed for reproducible boards (optional)\n\tpattern - RLE pattern file to load instead of a random board (optional)\n\t--checkpoint - snapshot the board to file every interval generations\n\t--restore - resume from a snapshot file instead of generation 0\n\t--print - write the board to prefix.<generation> every interval generations\n\t--stats - print one STATS line (generation, seconds, cells/s, halo/compute seconds) every n generations\n\t--verify - print one VERIFY line (generation, population) per generation\n\n",
 					*end_ptr_for_strtol;
 
-	if ( MPI_Init(&argc, &argv) != MPI_SUCCESS )
+	// Funneled threading: only the main thread of each rank calls MPI, the
+	// OpenMP threads stay inside the compute blocks
+	int provided;
+
+	if ( MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided) != MPI_SUCCESS )
 	{
 		fprintf(stderr, "MPI initialization error!\n");
 
@@ -100,14 +142,87 @@ int main( int argc, char* argv[] )
 		exit(EXIT_FAILURE);
 	}
 
-    // Randomly generated data
-    seed = 0;
     size = atoi(argv[1]);
     steps = atoi(argv[2]);
     print_interval = 0;
 
-    return_val = random_board(size, seed, board);
-    MPI_Allreduce(&return_val, &max_return_val, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    // Optional arguments: seed and pattern are positional, the snapshot
+    // options are flags so they can be combined with either
+    char    *pattern_file = NULL,
+            *checkpoint_file = NULL,
+            *restore_file = NULL,
+            *print_prefix = NULL;
+    int     checkpoint_interval = 0,
+            start_gen = 0,
+            positionals = 0,
+            verify_mode = 0;
+
+    seed = 0;
+
+    for ( int a=3; a<argc; ++a )
+    {
+        if ( strcmp(argv[a], "--checkpoint") == 0 && a+2 < argc )
+        {
+            checkpoint_interval = atoi(argv[a+1]);
+            checkpoint_file = argv[a+2];
+            a += 2;
+        }
+        else if ( strcmp(argv[a], "--print") == 0 && a+2 < argc )
+        {
+            print_interval = atoi(argv[a+1]);
+            print_prefix = argv[a+2];
+            a += 2;
+        }
+        else if ( strcmp(argv[a], "--restore") == 0 && a+1 < argc )
+            restore_file = argv[++a];
+        else if ( strcmp(argv[a], "--stats") == 0 && a+1 < argc )
+            stats_interval = atoi(argv[++a]);
+        else if ( strcmp(argv[a], "--verify") == 0 )
+            verify_mode = 1;
+        else if ( positionals == 0 )
+        {
+            seed = atoi(argv[a]);
+            ++positionals;
+        }
+        else
+        {
+            pattern_file = argv[a];
+            ++positionals;
+        }
+    }
+
+    // Lay the ranks out as a 2D grid of tiles over the board
+    int periods[2] = { 0, 0 };
+
+    dims[0] = 0;
+    dims[1] = 0;
+    MPI_Dims_create(nprocs, 2, dims);
+
+    // Fall back to row strips when the board is too narrow to split its
+    // packed rows on byte boundaries
+    if ( dims[1] > (size+7)/8 )
+    {
+        dims[0] = nprocs;
+        dims[1] = 1;
+    }
+
+    MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 1, &cart_comm);
+    MPI_Comm_rank(cart_comm, &myid);
+    MPI_Cart_coords(cart_comm, myid, 2, coords);
+
+    // Neighbor ranks (MPI_PROC_NULL beyond the board edge, which turns the
+    // matching sends and receives into no-ops)
+    MPI_Cart_shift(cart_comm, 0, 1, &north, &south);
+    MPI_Cart_shift(cart_comm, 1, 1, &west, &east);
+
+    // Build the local tile: from a snapshot, an RLE pattern or a random fill
+    if ( restore_file != NULL )
+        return_val = restore_board_mpi(restore_file, size, board, &start_gen, &local_alive);
+    else if ( pattern_file != NULL )
+        return_val = rle_board(pattern_file, size, board);
+    else
+        return_val = random_board(size, seed, board);
+    MPI_Allreduce(&return_val, &max_return_val, 1, MPI_INT, MPI_MAX, cart_comm);
     if ( max_return_val != 0 )
     {
         MPI_Finalize();
@@ -117,35 +232,111 @@ int main( int argc, char* argv[] )
  
     // Print initial information
     if ( myid == 0 )
-        fprintf(stderr, "Processing board of size %dx%d, %d generations, with %d processes...\n", size, size, steps, nprocs);
+    {
+#ifdef _OPENMP
+        fprintf(stderr, "Processing board of size %dx%d, %d generations, with %d processes (%dx%d tiles) and %d threads each...\n", size, size, steps, nprocs, dims[0], dims[1], omp_get_max_threads());
+#else
+        fprintf(stderr, "Processing board of size %dx%d, %d generations, with %d processes (%dx%d tiles)...\n", size, size, steps, nprocs, dims[0], dims[1]);
+#endif
+    }
 
     // Create a new board
-    if ( build_array(new_board, local_rows(myid, size)+2, size+2) == NULL )
+    if ( build_array(new_board, local_rows(coords[0], size)+2, local_cols(coords[1], size)+2) == NULL )
     {
         fprintf(stderr, "Unable to allocate space for board of size %d!\n", size);
-        
+
         MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
     }
     // Clear the board
     clear_border(new_board);
 
+    // Datatype for one ghost-height tile column, reused every exchange
+    MPI_Type_vector(local_rows(coords[0], size)+2, 1, local_cols(coords[1], size)+2, MPI_INT, &column_type);
+    MPI_Type_commit(&column_type);
+
     // Get initial time
     start_time_parallel = get_time();
 
-    // Loop to update and print the board
-    for ( int step=0; step<steps; ++step )
+    // A restored population must be reported even if no steps remain
+    if ( restore_file != NULL )
+        MPI_Reduce(&local_alive, &total_alive, 1, MPI_LONG_LONG, MPI_SUM, 0, cart_comm);
+
+    // The stats window starts where the run does
+    stats_last_time = get_time();
+
+    // Loop to update and print the board (resuming past the restored
+    // generations, if any)
+    for ( int step=start_gen; step<steps; ++step )
     {
-        // Update results
-        update_board(board, new_board);
+        // Update results; the local population is counted as it is written
+        local_alive = update_board(board, new_board);
+        // Reduce the per-rank population partials for this generation
+        MPI_Reduce(&local_alive, &total_alive, 1, MPI_LONG_LONG, MPI_SUM, 0, cart_comm);
+
+        // One population line per generation for verify.sh; no board hash
+        // here because the column splits land on byte boundaries, not on the
+        // 64-cell groups of verify.h, and gathering the board just to hash it
+        // would defeat the decomposition
+        if ( verify_mode && myid == 0 )
+            printf("VERIFY %d %lld\n", step+1, total_alive);
+
         // Swap old and new boards
         twoD_array_t *temp = board;
         board = new_board;
         new_board = temp;
+
+        // One machine-readable throughput line per stats window: generation,
+        // window seconds, global cell updates per second, and the slowest
+        // rank's halo-exchange vs compute seconds in the window — a rank
+        // stuck waiting in the exchange shows up as halo time
+        if ( stats_interval > 0 && (step+1) % stats_interval == 0 )
+        {
+            double  locals[2] = { halo_secs, comp_secs },
+                    maxes[2];
+
+            MPI_Reduce(locals, maxes, 2, MPI_DOUBLE, MPI_MAX, 0, cart_comm);
+
+            if ( myid == 0 )
+            {
+                double  now = get_time(),
+                        secs = now - stats_last_time;
+                double  cps = ( secs > 0 ) ? (double) stats_interval * size * size / secs : 0;
+
+                fprintf(stderr, "STATS %d %.6f %.3e %.6f %.6f\n", step+1, secs, cps, maxes[0], maxes[1]);
+
+                stats_last_time = now;
+            }
+
+            halo_secs = 0.0;
+            comp_secs = 0.0;
+        }
+
+        // Periodically snapshot the board so the run can be resumed later
+        if ( checkpoint_interval > 0 && (step+1) % checkpoint_interval == 0 )
+            if ( checkpoint_board_mpi(checkpoint_file, board, size, step+1) != 0 && myid == 0 )
+                fprintf(stderr, "[!] Unable to write the snapshot %s at generation #%d.\n", checkpoint_file, step+1);
+
+        // Periodic board output, one snapshot file per dump; every rank
+        // writes its own tile collectively, so the cost scales with the
+        // per-rank data instead of serializing through rank 0
+        if ( print_interval > 0 && (step+1) % print_interval == 0 )
+        {
+            char out_path[1024];
+
+            snprintf(out_path, sizeof(out_path), "%s.%d", print_prefix, step+1);
+
+            if ( checkpoint_board_mpi(out_path, board, size, step+1) != 0 && myid == 0 )
+                fprintf(stderr, "[!] Unable to write the board output %s.\n", out_path);
+        }
     }
 
     // Get end time
     end_time = get_time();
 
+    // Print the final population
+    if ( myid == 0 )
+        fprintf(stderr, "\n-> Alive cells at the generation #%d: %lld\n", steps, total_alive);
+
     // Print the time results
     if ( myid == 0 )
     {
@@ -154,6 +345,7 @@ int main( int argc, char* argv[] )
     }
 
     // Free memory
+    MPI_Type_free(&column_type);
     free_array(board);
     free_array(new_board);
 
@@ -172,7 +364,8 @@ twoD_array_t *build_array( twoD_array_t * a, int rows, int cols )
     if ( (a->elems = malloc(rows * sizeof(int *))) == NULL )
         return NULL;
     
-    if ( (temp = malloc(rows * cols * sizeof(int))) == NULL )
+    // Huge-page backed for large tiles, zeroed and lazily faulted either way
+    if ( (temp = huge_alloc(rows * cols * sizeof(int))) == NULL )
     {
         free (a->elems);
         
@@ -188,7 +381,7 @@ twoD_array_t *build_array( twoD_array_t * a, int rows, int cols )
 // Function that remove an array from memory
 void free_array( twoD_array_t * a )
 {
-    free(a->elems[0]);
+    huge_free(a->elems[0]);
     free(a->elems);
 }
 
@@ -210,7 +403,7 @@ void clear_border( twoD_array_t *board )
 
 // Function that read initial configuration from file, and return 0 if OK
 int read_board(FILE* infile, twoD_array_t *board) {
-    int size, temp, start_row, end_row;
+    int size, temp, start_row, end_row, start_col, end_col;
 
     if ( fscanf(infile, "%d", &size) != 1 )
     {
@@ -220,13 +413,15 @@ int read_board(FILE* infile, twoD_array_t *board) {
         return 1;
     }
 
-    start_row = local_start_row(myid, size);
-    end_row = local_end_row(myid, size);
+    start_row = local_start_row(coords[0], size);
+    end_row = local_end_row(coords[0], size);
+    start_col = local_start_col(coords[1], size);
+    end_col = local_end_col(coords[1], size);
 
-    if ( build_array(board, local_rows(myid, size)+2, size+2) == NULL )
+    if ( build_array(board, local_rows(coords[0], size)+2, local_cols(coords[1], size)+2) == NULL )
     {
         fprintf(stderr, "Unable to allocate space for board of size %d!\n", size);
-        
+
         return 2;
     }
 
@@ -237,19 +432,19 @@ int read_board(FILE* infile, twoD_array_t *board) {
             if ( fscanf(infile, "%d", &temp) != 1 )
             {
                 fprintf(stderr, "Unable to read values for board!\n");
-                
+
                 return 1;
             }
 
             if ( temp == 0 || temp == 1 )
             {
-                if ( start_row <= i && i < end_row )
-                    board->elems[i-start_row+1][j] = temp;
+                if ( start_row <= i && i < end_row && start_col <= j && j < end_col )
+                    board->elems[i-start_row+1][j-start_col+1] = temp;
             }
             else
             {
                 fprintf(stderr, "Unable to read values for board!\n");
-                
+
                 return 1;
             }
         }
@@ -263,99 +458,300 @@ int read_board(FILE* infile, twoD_array_t *board) {
 // Function that generate random board, and return 0 if OK
 int random_board( int size, int seed, twoD_array_t *board )
 {
-    int temp, start_row, end_row;
+    int start_row, end_row, start_col, end_col;
 
-    start_row = local_start_row(myid, size);
-    end_row = local_end_row(myid, size);
+    start_row = local_start_row(coords[0], size);
+    end_row = local_end_row(coords[0], size);
+    start_col = local_start_col(coords[1], size);
+    end_col = local_end_col(coords[1], size);
 
-    if ( build_array(board, local_rows(myid, size)+2, size+2) == NULL )
+    if ( build_array(board, local_rows(coords[0], size)+2, local_cols(coords[1], size)+2) == NULL )
     {
         fprintf(stderr, "Unable to allocate space for board of size %d!\n", size);
-        
+
         return 2;
     }
 
-    srand(seed);
-    
-    for ( int i=1; i<=size; ++i )
+    // The counter-based PRNG hashes (seed, row, col), so each rank fills
+    // only its own tile and the board is identical regardless of the
+    // process count (and matches the shared-memory engines for the seed)
+    for ( int i=start_row; i<end_row; ++i )
+        for ( int j=start_col; j<end_col; ++j )
+            board->elems[i-start_row+1][j-start_col+1] = prand_cell(seed, i-1, j-1);
+
+    clear_border(board);
+
+    return 0;
+}
+
+// Context for streaming RLE pattern cells into this rank's tile
+typedef struct RleTile
+{
+    twoD_array_t	*board;
+    int				size;
+    int				start_row;
+    int				end_row;
+    int				start_col;
+    int				end_col;
+} RleTile;
+
+// Function that writes one alive pattern cell if this rank owns it
+static void rle_set_cell(void *ctx, long long row, long long col)
+{
+    RleTile	*t = (RleTile*) ctx;
+    int		r = (int) row + 1, // board rows/columns are 1-based
+            c = (int) col + 1;
+
+    if ( row >= t->size || col >= t->size )
+        return;
+
+    if ( t->start_row <= r && r < t->end_row && t->start_col <= c && c < t->end_col )
+        t->board->elems[r - t->start_row + 1][c - t->start_col + 1] = ALIVE;
+}
+
+// Function that loads an RLE pattern into the local tile, and return 0 if OK
+int rle_board( const char *path, int size, twoD_array_t *board )
+{
+    RleTile		ctx;
+    long long	pat_w = 0,
+				pat_h = 0;
+
+    if ( build_array(board, local_rows(coords[0], size)+2, local_cols(coords[1], size)+2) == NULL )
     {
-        for ( int j=1; j<=size; ++j )
-        {
-            temp = (rand() < (RAND_MAX/2)) ? 0 : 1;
+        fprintf(stderr, "Unable to allocate space for board of size %d!\n", size);
 
-            if ( start_row <= i && i < end_row )
-                board->elems[i-start_row+1][j] = temp;
-        }
+        return 2;
     }
 
+    // The pattern background is dead, so clear the whole tile first
+    memset(board->elems[0], 0, board->rows * board->cols * sizeof(int));
+
+    ctx.board = board;
+    ctx.size = size;
+    ctx.start_row = local_start_row(coords[0], size);
+    ctx.end_row = local_end_row(coords[0], size);
+    ctx.start_col = local_start_col(coords[1], size);
+    ctx.end_col = local_end_col(coords[1], size);
+
+    if ( rle_load(path, &pat_w, &pat_h, rle_set_cell, &ctx) != 0 )
+    {
+        if ( myid == 0 )
+            fprintf(stderr, "Unable to load the pattern %s!\n", path);
+
+        return 1;
+    }
+
+    if ( myid == 0 && (pat_w > size || pat_h > size) )
+        fprintf(stderr, "[!] Pattern (%lldx%lld) is larger than the board and was clipped.\n", pat_w, pat_h);
+
     clear_border(board);
 
     return 0;
 }
 
-// Function that update a board configuration
-void update_board( twoD_array_t *board, twoD_array_t *new_board )
+// Function that snapshots the distributed board with MPI-IO; every rank writes
+// its tile's byte-aligned row segments through a strided file view (the format
+// matches checkpoint.c, so serial and MPI runs can resume from each other's
+// files), and return 0 if OK
+int checkpoint_board_mpi( const char *path, twoD_array_t *board, int size, int generation )
 {
-    int size;
-    MPI_Status status;
-    MPI_Request req_recv_above, req_recv_below, req_send_above, req_send_below;
+    long long       row_bytes = checkpoint_row_bytes(size);
+    int             rows = local_rows(coords[0], size),
+                    cols = local_cols(coords[1], size),
+                    start_row = local_start_row(coords[0], size),
+                    start_col = local_start_col(coords[1], size),
+                    seg_bytes = (cols + 7) / 8,
+                    failed = 0,
+                    max_failed;
+    unsigned char   *buf;
+    MPI_File        fh;
+    MPI_Datatype    filetype;
+    MPI_Offset      disp = CHECKPOINT_HEADER_BYTES + (MPI_Offset) (start_row-1) * row_bytes + (start_col-1)/8;
+
+    // Pack this rank's tile 1 bit per cell, row by row (the tile starts on a
+    // byte boundary of the file row, so bit 0 of the segment is column 1)
+    buf = calloc((size_t) rows * seg_bytes, 1);
+
+    if ( buf == NULL )
+        failed = 1;
+    else
+        for ( int i=1; i<=rows; ++i )
+            for ( int j=1; j<=cols; ++j )
+                if ( board->elems[i][j] )
+                    buf[(i-1)*seg_bytes + (j-1)/8] |= (unsigned char) (1u << ((j-1) % 8));
 
-    size = board->cols-2;
+    MPI_Allreduce(&failed, &max_failed, 1, MPI_INT, MPI_MAX, cart_comm);
 
-    // Exchange information with neighbors
-    if ( myid != 0 )
+    if ( max_failed )
     {
-        // Receive bottom row from neighbor above
-        MPI_Irecv(&(board->elems[0][1]), size, MPI_INT, myid-1, EXCHANGE_TAG, MPI_COMM_WORLD, &req_recv_above);
+        free(buf);
+
+        return 1;
     }
 
-    if ( myid != (nprocs-1) )
+    if ( MPI_File_open(cart_comm, path, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS )
     {
-        // Receive top row from neighbor below
-        MPI_Irecv(&(board->elems[local_rows(myid, size)+1][1]), size, MPI_INT, myid+1, EXCHANGE_TAG, MPI_COMM_WORLD, &req_recv_below);
+        free(buf);
+
+        return 1;
     }
 
-    if ( myid != 0 )
+    // Rank 0 writes the header, everyone writes their tile collectively
+    // through a view selecting its row segments out of the full file rows
+    if ( myid == 0 )
     {
-        // Send top row to neighbor above
-        MPI_Isend(&(board->elems[1][1]), size, MPI_INT, myid-1, EXCHANGE_TAG, MPI_COMM_WORLD, &req_send_above);
+        unsigned char   header[CHECKPOINT_HEADER_BYTES];
+        uint32_t        version = CHECKPOINT_VERSION;
+        int64_t         size64 = size,
+                        gen64 = generation;
+
+        memcpy(header, CHECKPOINT_MAGIC, 4);
+        memcpy(header+4, &version, 4);
+        memcpy(header+8, &size64, 8);
+        memcpy(header+16, &gen64, 8);
+
+        MPI_File_write_at(fh, 0, header, CHECKPOINT_HEADER_BYTES, MPI_BYTE, MPI_STATUS_IGNORE);
     }
 
-    if ( myid != (nprocs-1) )
+    MPI_Type_vector(rows, seg_bytes, (int) row_bytes, MPI_BYTE, &filetype);
+    MPI_Type_commit(&filetype);
+
+    MPI_File_set_view(fh, disp, MPI_BYTE, filetype, "native", MPI_INFO_NULL);
+    MPI_File_write_all(fh, buf, rows * seg_bytes, MPI_BYTE, MPI_STATUS_IGNORE);
+
+    MPI_Type_free(&filetype);
+    MPI_File_close(&fh);
+    free(buf);
+
+    return 0;
+}
+
+// Function that restores the distributed board from a snapshot with MPI-IO,
+// filling in the saved generation and this rank's population, and return 0 if OK
+int restore_board_mpi( const char *path, int size, twoD_array_t *board, int *generation, long long *local_alive )
+{
+    long long       row_bytes = checkpoint_row_bytes(size),
+                    alives = 0;
+    int             rows = local_rows(coords[0], size),
+                    cols = local_cols(coords[1], size),
+                    start_row = local_start_row(coords[0], size),
+                    start_col = local_start_col(coords[1], size),
+                    seg_bytes = (cols + 7) / 8,
+                    header_ok = 0,
+                    failed = 0,
+                    max_failed;
+    int64_t         gen64 = 0;
+    unsigned char   *buf;
+    MPI_File        fh;
+    MPI_Datatype    filetype;
+    MPI_Offset      disp = CHECKPOINT_HEADER_BYTES + (MPI_Offset) (start_row-1) * row_bytes + (start_col-1)/8;
+
+    // An allocation failure on one rank must not leave its peers alone in
+    // the collective open and read below, so every rank learns about it first
+    if ( build_array(board, rows+2, cols+2) == NULL )
     {
-        // Send bottom row to neighbor below
-        MPI_Isend(&(board->elems[local_rows(myid, size)][1]), size, MPI_INT, myid+1, EXCHANGE_TAG, MPI_COMM_WORLD, &req_send_below);
+        fprintf(stderr, "Unable to allocate space for board of size %d!\n", size);
+
+        failed = 1;
     }
 
-    // Wait for communication to complete
-    if ( myid != 0 )
+    MPI_Allreduce(&failed, &max_failed, 1, MPI_INT, MPI_MAX, cart_comm);
+
+    if ( max_failed )
+        return 2;
+
+    if ( MPI_File_open(cart_comm, path, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS )
     {
-        // Receive bottom row from neighbor above
-        MPI_Wait(&req_recv_above, &status);
+        if ( myid == 0 )
+            fprintf(stderr, "Unable to restore the snapshot %s!\n", path);
+
+        return 1;
     }
 
-    if ( myid != (nprocs-1) )
+    // Rank 0 validates the header, then shares the verdict and the generation
+    if ( myid == 0 )
     {
-        // Receive top row from neighbor below
-        MPI_Wait(&req_recv_below, &status);
+        unsigned char   header[CHECKPOINT_HEADER_BYTES];
+        int64_t         size64 = 0;
+
+        if ( MPI_File_read_at(fh, 0, header, CHECKPOINT_HEADER_BYTES, MPI_BYTE, MPI_STATUS_IGNORE) == MPI_SUCCESS )
+        {
+            memcpy(&size64, header+8, 8);
+            memcpy(&gen64, header+16, 8);
+
+            header_ok = ( memcmp(header, CHECKPOINT_MAGIC, 4) == 0 && size64 == size );
+        }
+
+        if ( !header_ok )
+            fprintf(stderr, "Unable to restore the snapshot %s (wrong format or board size)!\n", path);
     }
 
-    if ( myid != 0 )
+    MPI_Bcast(&header_ok, 1, MPI_INT, 0, cart_comm);
+
+    if ( !header_ok )
     {
-        // Send top row to neighbor above
-        MPI_Wait(&req_send_above, &status);
+        MPI_File_close(&fh);
+
+        return 1;
     }
 
-    if ( myid != (nprocs-1) )
+    MPI_Bcast(&gen64, 1, MPI_LONG_LONG, 0, cart_comm);
+
+    // Read this rank's tile collectively through the same strided view the
+    // writer used, then unpack it, counting as we go
+    buf = malloc((size_t) rows * seg_bytes);
+
+    if ( buf == NULL )
+        failed = 1;
+
+    MPI_Allreduce(&failed, &max_failed, 1, MPI_INT, MPI_MAX, cart_comm);
+
+    if ( max_failed )
     {
-        // Send bottom row to neighbor below
-        MPI_Wait(&req_send_below, &status);
+        free(buf);
+        MPI_File_close(&fh);
+
+        return 2;
     }
 
-    // Update board
-    for ( int i=1; i<=board->rows-2; ++i )
+    MPI_Type_vector(rows, seg_bytes, (int) row_bytes, MPI_BYTE, &filetype);
+    MPI_Type_commit(&filetype);
+
+    MPI_File_set_view(fh, disp, MPI_BYTE, filetype, "native", MPI_INFO_NULL);
+    MPI_File_read_all(fh, buf, rows * seg_bytes, MPI_BYTE, MPI_STATUS_IGNORE);
+
+    MPI_Type_free(&filetype);
+
+    for ( int i=1; i<=rows; ++i )
+        for ( int j=1; j<=cols; ++j )
+        {
+            board->elems[i][j] = (buf[(i-1)*seg_bytes + (j-1)/8] >> ((j-1) % 8)) & 1;
+            alives += board->elems[i][j];
+        }
+
+    MPI_File_close(&fh);
+    free(buf);
+
+    clear_border(board);
+
+    *generation = (int) gen64;
+    *local_alive = alives;
+
+    return 0;
+}
+
+// Function that update a rectangular block of the tile; returns its alive
+// count. When compiled with OpenMP the rows of the block are split between
+// the threads of the rank, so one rank per socket with threads inside
+// replaces one rank per core (hybrid mode; only the main thread calls MPI)
+static long long update_block( twoD_array_t *board, twoD_array_t *new_board, int i0, int i1, int j0, int j1 )
+{
+    long long alives = 0;
+
+    #pragma omp parallel for reduction(+: alives)
+    for ( int i=i0; i<=i1; ++i )
     {
-        for ( int j=1; j<=board->cols-2; ++j )
+        for ( int j=j0; j<=j1; ++j )
         {
             int nbrs =
 		                board->elems[i-1][j-1]	+
@@ -381,97 +777,128 @@ void update_board( twoD_array_t *board, twoD_array_t *new_board )
                 else
                     new_board->elems[i][j] = DEAD;
             }
+
+            // Accumulate the local population as it is written
+            alives += new_board->elems[i][j];
         }
     }
+
+    return alives;
 }
 
-// Function that print the current board configuration
-void print_board(FILE* outfile, twoD_array_t *board)
+// Function that charges the time since *t_prev to one stats bucket and
+// advances the mark; a no-op when --stats is off
+static void stats_mark( double *bucket, double *t_prev )
 {
-    int size, temp, process_for_row;
-    int *temprow;
-    MPI_Status status;
+    double now;
 
-    size = board->cols-2;
+    if ( stats_interval <= 0 )
+        return;
 
-    // Data from process zero
-    if ( myid == 0 )
-    {
-        temprow = malloc(size * sizeof(int));
-        
-        if ( temprow == NULL )
-        {
-            fprintf(stderr, "Unable to allocate space for printing board!\n");
-            
-            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
-        }
+    now = get_time();
+    *bucket += now - *t_prev;
+    *t_prev = now;
+}
 
-        for ( int i=1; i<=size; ++i )
-        {
-            process_for_row = process_owning_row(i, size);
-            
-            if ( process_for_row != 0 )
-                MPI_Recv(temprow, size, MPI_INT, process_for_row, PRINT_TAG, MPI_COMM_WORLD, &status);
-            
-            for ( int j=1; j<=size; ++j )
-            {
-                if ( process_for_row == 0 )
-                    temp = board->elems[i][j];
-                else
-                    temp = temprow[j-1];
-                if ( temp == 0 )
-                    fprintf(outfile, DEAD_CHAR);
-                else
-                    fprintf(outfile, ALIVE_CHAR);
-            }
+// Function that update a board configuration, overlapping the halo exchange
+// with the cells that do not depend on it; returns this rank's alive count
+long long update_board( twoD_array_t *board, twoD_array_t *new_board )
+{
+    int rows, cols;
+    long long alives = 0;
+    double t_prev = ( stats_interval > 0 ) ? get_time() : 0.0;
+    MPI_Request row_reqs[4], col_reqs[4];
 
-            fprintf(outfile, "\n");
-        }
+    rows = board->rows-2;
+    cols = board->cols-2;
 
-        free(temprow);
-    }
-    // Other processes send to procces zero
-    else
-    {
-        for ( int i=1; i<=local_rows(myid, size); ++i )
-            MPI_Send(&(board->elems[i][1]), size, MPI_INT, 0, PRINT_TAG, MPI_COMM_WORLD);
-    }
+    // Exchange the north/south edge rows first (contiguous in memory; sends
+    // and receives against MPI_PROC_NULL complete immediately at the edges)
+    MPI_Irecv(&(board->elems[0][1]), cols, MPI_INT, north, EXCHANGE_TAG, cart_comm, &row_reqs[0]);
+    MPI_Irecv(&(board->elems[rows+1][1]), cols, MPI_INT, south, EXCHANGE_TAG, cart_comm, &row_reqs[1]);
+    MPI_Isend(&(board->elems[1][1]), cols, MPI_INT, north, EXCHANGE_TAG, cart_comm, &row_reqs[2]);
+    MPI_Isend(&(board->elems[rows][1]), cols, MPI_INT, south, EXCHANGE_TAG, cart_comm, &row_reqs[3]);
+    stats_mark(&halo_secs, &t_prev);
+
+    // While the rows are in flight, compute the interior cells, which read
+    // no ghost data at all
+    alives += update_block(board, new_board, 2, rows-1, 2, cols-1);
+    stats_mark(&comp_secs, &t_prev);
+
+    MPI_Waitall(4, row_reqs, MPI_STATUSES_IGNORE);
+
+    // Then the west/east edge columns including the ghost rows just received,
+    // so the diagonal corner cells ride along without extra messages
+    MPI_Irecv(&(board->elems[0][0]), 1, column_type, west, EXCHANGE_TAG, cart_comm, &col_reqs[0]);
+    MPI_Irecv(&(board->elems[0][cols+1]), 1, column_type, east, EXCHANGE_TAG, cart_comm, &col_reqs[1]);
+    MPI_Isend(&(board->elems[0][1]), 1, column_type, west, EXCHANGE_TAG, cart_comm, &col_reqs[2]);
+    MPI_Isend(&(board->elems[0][cols]), 1, column_type, east, EXCHANGE_TAG, cart_comm, &col_reqs[3]);
+    stats_mark(&halo_secs, &t_prev);
+
+    // While the columns are in flight, compute the top and bottom tile rows,
+    // which depend on the ghost rows but not on the ghost columns
+    alives += update_block(board, new_board, 1, 1, 2, cols-1);
+
+    if ( rows > 1 )
+        alives += update_block(board, new_board, rows, rows, 2, cols-1);
+
+    stats_mark(&comp_secs, &t_prev);
+
+    MPI_Waitall(4, col_reqs, MPI_STATUSES_IGNORE);
+    stats_mark(&halo_secs, &t_prev);
+
+    // Finally the left and right tile columns, which need everything
+    alives += update_block(board, new_board, 1, rows, 1, 1);
+
+    if ( cols > 1 )
+        alives += update_block(board, new_board, 1, rows, cols, cols);
+
+    stats_mark(&comp_secs, &t_prev);
+
+    return alives;
 }
 
-// Function that get the number of rows per process
-int rows_per_process( int size )
+// Function that return local start row (absolute row number); rows are split
+// evenly between the tile rows, so no coordinate ends up with a negative count
+int local_start_row( int row_coord, int size )
 {
-    return (size + (nprocs-1)) / nprocs;
+    return (int) ((long long) row_coord * size / dims[0]) + 1;
 }
 
-// Function that get the number of rows for current process
-int local_rows( int proc_id, int size )
+// Function that return local end row (absolute row number)
+int local_end_row( int row_coord, int size )
 {
-    if ( proc_id == (nprocs-1) )
-        return size - ((nprocs-1) * rows_per_process(size));
-    else
-        return rows_per_process(size);
+    return (int) ((long long) (row_coord+1) * size / dims[0]) + 1;
 }
 
-// Function that return local start row (absolute row number)
-int local_start_row( int proc_id, int size )
+// Function that get the number of rows of a tile row
+int local_rows( int row_coord, int size )
 {
-    return proc_id * rows_per_process(size) + 1;
+    return local_end_row(row_coord, size) - local_start_row(row_coord, size);
 }
 
-// Function that return local end row (absolute row number)
-int local_end_row( int proc_id, int size )
+// Function that return local start column (absolute column number); columns
+// are split on byte boundaries of the packed snapshot rows (see note 4)
+int local_start_col( int col_coord, int size )
 {
-    if ( proc_id == (nprocs-1) )
-        return size + 1;
-    else
-        return local_start_row(proc_id, size) + rows_per_process(size);
+    long long bytes = checkpoint_row_bytes(size);
+
+    return (int) ((long long) col_coord * bytes / dims[1]) * 8 + 1;
+}
+
+// Function that return local end column (absolute column number)
+int local_end_col( int col_coord, int size )
+{
+    long long   bytes = checkpoint_row_bytes(size);
+    int         end = (int) ((long long) (col_coord+1) * bytes / dims[1]) * 8 + 1;
+
+    return ( end > size+1 ) ? size+1 : end;
 }
 
-// Function that return ID of process owning row
-int process_owning_row( int row, int size )
+// Function that get the number of columns of a tile column
+int local_cols( int col_coord, int size )
 {
-    return (row-1) / rows_per_process(size);
+    return local_end_col(col_coord, size) - local_start_col(col_coord, size);
 }
 
 // Function to get time in seconds
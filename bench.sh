@@ -0,0 +1,66 @@
+#!/bin/sh
+# Reproducible benchmark over every engine: fixed seed, fixed matrix of
+# sizes/generations/thread counts, one warm-up run before each timed run.
+# Emits CSV on stdout: engine,size,generations,threads,seconds,cells_per_sec,speedup,efficiency
+#
+# Usage: ./bench.sh   (binaries are built by 'make bench')
+
+SEED=42
+SIZES="${SIZES:-256 512 1024}"
+GENERATIONS="${GENERATIONS:-20}"
+THREADS="${THREADS:-1 2 4}"
+
+# Run a command once and echo the elapsed wall-clock seconds
+run_timed()
+{
+	start=$(date +%s.%N)
+	"$@" > /dev/null 2>&1
+	end=$(date +%s.%N)
+	awk "BEGIN { printf \"%.4f\", $end - $start }"
+}
+
+# Emit one CSV row; speedup/efficiency are relative to the serial time
+emit_row()
+{
+	engine=$1; size=$2; gens=$3; threads=$4; secs=$5; serial_secs=$6
+
+	awk "BEGIN {
+		cells = $size * $size * $gens;
+		speedup = ($secs > 0) ? $serial_secs / $secs : 0;
+		printf \"%s,%d,%d,%d,%s,%.0f,%.3f,%.3f\n\",
+			\"$engine\", $size, $gens, $threads, \"$secs\",
+			($secs > 0) ? cells / $secs : 0, speedup, speedup / $threads;
+	}"
+}
+
+echo "engine,size,generations,threads,seconds,cells_per_sec,speedup,efficiency"
+
+for size in $SIZES; do
+	# Serial engine is the baseline for speedup numbers at this size
+	./game "$size" "$GENERATIONS" "$SEED" > /dev/null 2>&1	# warm-up
+	serial_secs=$(run_timed ./game "$size" "$GENERATIONS" "$SEED")
+	emit_row game "$size" "$GENERATIONS" 1 "$serial_secs" "$serial_secs"
+
+	for engine in game_bit game_hashlife game_tmpl game_cuda; do
+		[ -x "./$engine" ] || continue
+		./"$engine" "$size" "$GENERATIONS" "$SEED" > /dev/null 2>&1	# warm-up
+		secs=$(run_timed ./"$engine" "$size" "$GENERATIONS" "$SEED")
+		emit_row "$engine" "$size" "$GENERATIONS" 1 "$secs" "$serial_secs"
+	done
+
+	for threads in $THREADS; do
+		for engine in game_omp game_pthread game_sparse; do
+			[ -x "./$engine" ] || continue
+			./"$engine" "$size" "$GENERATIONS" "$threads" "$SEED" > /dev/null 2>&1	# warm-up
+			secs=$(run_timed ./"$engine" "$size" "$GENERATIONS" "$threads" "$SEED")
+			emit_row "$engine" "$size" "$GENERATIONS" "$threads" "$secs" "$serial_secs"
+		done
+
+		# MPI engine only when it was built and mpirun is around
+		if [ -x MPI/game_mpi ] && command -v mpirun > /dev/null 2>&1; then
+			mpirun -np "$threads" MPI/game_mpi "$size" "$GENERATIONS" "$SEED" > /dev/null 2>&1	# warm-up
+			secs=$(run_timed mpirun -np "$threads" MPI/game_mpi "$size" "$GENERATIONS" "$SEED")
+			emit_row game_mpi "$size" "$GENERATIONS" "$threads" "$secs" "$serial_secs"
+		fi
+	done
+done
@@ -0,0 +1,273 @@
+/* File:    checkpoint.c
+ * Purpose: Packed binary snapshot format shared by the engines (see checkpoint.h).
+ *
+ * Notes:
+ *  1.  Snapshots are written through mmap: the file is sized once with
+ *      ftruncate and the packed rows are streamed straight into the mapping,
+ *      so both write and restore are O(file size) sequential passes with no
+ *      cell-by-cell parsing.
+ *  2.  checkpoint_async_write() stages a copy of the board and lets a
+ *      dedicated I/O thread do the packing and writing, so periodic
+ *      archiving no longer stalls the generation loop.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "checkpoint.h"
+
+// Async writer state: one snapshot can be in flight while the compute loop
+// runs on; a second request waits until the writer catches up
+static pthread_t		writer_thread;
+static pthread_mutex_t	writer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	writer_cond = PTHREAD_COND_INITIALIZER;
+static int				*staging = NULL;	// Private copy the writer packs from
+static long long		staging_size,
+						staging_gen;
+static char				staging_path[4096];
+static int				staging_pending = 0,
+						writer_running = 0;
+
+// Function that returns the packed payload bytes per board row
+long long checkpoint_row_bytes(long long s)
+{
+	return (s + 7) / 8;
+}
+
+// Function that fills in a snapshot header
+static void fill_header(unsigned char *h, long long s, long long generation)
+{
+	uint32_t version = CHECKPOINT_VERSION;
+	int64_t	size64 = s,
+			gen64 = generation;
+
+	memcpy(h, CHECKPOINT_MAGIC, 4);
+	memcpy(h+4, &version, 4);
+	memcpy(h+8, &size64, 8);
+	memcpy(h+16, &gen64, 8);
+}
+
+// Function that snapshots a padded grid into path via mmap; returns 0 on success
+int checkpoint_write(const char *path, const int *m, long long s, long long generation)
+{
+	long long		row_bytes = checkpoint_row_bytes(s),
+					total = CHECKPOINT_HEADER_BYTES + s * row_bytes,
+					p = s+2,
+					i,
+					j;
+	int				fd;
+	unsigned char	*map;
+
+	fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+	if ( fd < 0 )
+		return 1;
+
+	if ( ftruncate(fd, total) != 0 )
+	{
+		close(fd);
+
+		return 1;
+	}
+
+	map = (unsigned char*) mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if ( map == MAP_FAILED )
+	{
+		close(fd);
+
+		return 1;
+	}
+
+	fill_header(map, s, generation);
+
+	// Pack the interior cells 1 bit each, row by row (the mapping starts
+	// zeroed because the file was just truncated to size)
+	for ( i=0; i<s; i++ )
+	{
+		unsigned char *row = map + CHECKPOINT_HEADER_BYTES + i * row_bytes;
+
+		for ( j=0; j<s; j++ )
+			if ( m[(i+1)*p + (j+1)] )
+				row[j/8] |= (unsigned char) (1u << (j % 8));
+	}
+
+	// Push the snapshot to disk before reporting success
+	msync(map, total, MS_SYNC);
+	munmap(map, total);
+	close(fd);
+
+	return 0;
+}
+
+// Function that restores a padded grid from a snapshot; returns 0 on success
+int checkpoint_restore(const char *path, int *m, long long s, long long *generation, long long *alive_count)
+{
+	long long		row_bytes = checkpoint_row_bytes(s),
+					total = CHECKPOINT_HEADER_BYTES + s * row_bytes,
+					p = s+2,
+					i,
+					j,
+					alives = 0;
+	int				fd;
+	int64_t			size64,
+					gen64;
+	unsigned char	*map;
+	struct stat		st;
+
+	fd = open(path, O_RDONLY);
+
+	if ( fd < 0 )
+		return 1;
+
+	if ( fstat(fd, &st) != 0 || st.st_size < total )
+	{
+		close(fd);
+
+		return 1;
+	}
+
+	map = (unsigned char*) mmap(NULL, total, PROT_READ, MAP_SHARED, fd, 0);
+
+	if ( map == MAP_FAILED )
+	{
+		close(fd);
+
+		return 1;
+	}
+
+	// Validate the header against the requested board
+	memcpy(&size64, map+8, 8);
+	memcpy(&gen64, map+16, 8);
+
+	if ( memcmp(map, CHECKPOINT_MAGIC, 4) != 0 || size64 != s )
+	{
+		munmap(map, total);
+		close(fd);
+
+		return 1;
+	}
+
+	// Unpack the payload into the interior cells, counting as we go
+	for ( i=0; i<s; i++ )
+	{
+		const unsigned char *row = map + CHECKPOINT_HEADER_BYTES + i * row_bytes;
+
+		for ( j=0; j<s; j++ )
+		{
+			m[(i+1)*p + (j+1)] = (row[j/8] >> (j % 8)) & 1;
+			alives += m[(i+1)*p + (j+1)];
+		}
+	}
+
+	*generation = gen64;
+	*alive_count = alives;
+
+	munmap(map, total);
+	close(fd);
+
+	return 0;
+}
+
+// Function that runs on the I/O thread: waits for a staged snapshot and
+// writes it with the regular synchronous path
+static void *writer_main(void *unused)
+{
+	(void) unused;
+
+	pthread_mutex_lock(&writer_lock);
+
+	while ( writer_running || staging_pending )
+	{
+		if ( !staging_pending )
+		{
+			pthread_cond_wait(&writer_cond, &writer_lock);
+
+			continue;
+		}
+
+		// Write without holding the lock, so the engine can keep computing
+		// (it only blocks if it stages again before this write finishes)
+		pthread_mutex_unlock(&writer_lock);
+
+		if ( checkpoint_write(staging_path, staging, staging_size, staging_gen) != 0 )
+			printf("\n[!] Unable to write the snapshot %s at generation #%lld.\n", staging_path, staging_gen);
+
+		pthread_mutex_lock(&writer_lock);
+		staging_pending = 0;
+		pthread_cond_broadcast(&writer_cond);
+	}
+
+	pthread_mutex_unlock(&writer_lock);
+
+	return NULL;
+}
+
+// Function that stages a copy of the board for the I/O thread; returns 0 on success
+int checkpoint_async_write(const char *path, const int *m, long long s, long long generation)
+{
+	long long	cells = (s+2) * (s+2);
+
+	pthread_mutex_lock(&writer_lock);
+
+	// Start the writer on the first snapshot
+	if ( !writer_running )
+	{
+		staging = (int*) malloc(cells * sizeof(int));
+
+		if ( staging == NULL || pthread_create(&writer_thread, NULL, writer_main, NULL) != 0 )
+		{
+			free(staging);
+			staging = NULL;
+			pthread_mutex_unlock(&writer_lock);
+
+			return 1;
+		}
+
+		writer_running = 1;
+	}
+
+	// Backpressure: wait only if the previous snapshot is still in flight
+	while ( staging_pending )
+		pthread_cond_wait(&writer_cond, &writer_lock);
+
+	memcpy(staging, m, cells * sizeof(int));
+	snprintf(staging_path, sizeof(staging_path), "%s", path);
+	staging_size = s;
+	staging_gen = generation;
+	staging_pending = 1;
+
+	pthread_cond_broadcast(&writer_cond);
+	pthread_mutex_unlock(&writer_lock);
+
+	return 0;
+}
+
+// Function that drains any pending snapshot and stops the writer thread
+void checkpoint_async_finish()
+{
+	pthread_mutex_lock(&writer_lock);
+
+	if ( !writer_running )
+	{
+		pthread_mutex_unlock(&writer_lock);
+
+		return;
+	}
+
+	writer_running = 0;
+	pthread_cond_broadcast(&writer_cond);
+	pthread_mutex_unlock(&writer_lock);
+
+	pthread_join(writer_thread, NULL);
+
+	free(staging);
+	staging = NULL;
+}
@@ -0,0 +1,42 @@
+/* File:    checkpoint.h
+ * Purpose: Packed binary snapshot format shared by the engines, so long runs
+ *          can survive node reboots and resume where they stopped.
+ *
+ * Notes:
+ *  1.  Layout: 24-byte header (magic "GOLC", version, board size, generation)
+ *      followed by the board packed 1 bit per cell, row-major,
+ *      (size+7)/8 bytes per row, LSB-first inside each byte.
+ *  2.  The fixed bytes-per-row stride is what lets the MPI engine read and
+ *      write its strip at a computed offset with MPI-IO against the same files.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+// Snapshot header constants
+#define CHECKPOINT_MAGIC	"GOLC"
+#define CHECKPOINT_VERSION	1
+#define CHECKPOINT_HEADER_BYTES	24
+
+// Function that returns the packed payload bytes per board row
+long long checkpoint_row_bytes(long long s);
+
+// Function that snapshots a padded (s+2)x(s+2) grid into path via mmap;
+// returns 0 on success
+int checkpoint_write(const char *path, const int *m, long long s, long long generation);
+
+// Function that restores a padded grid from a snapshot, filling in the saved
+// generation number and the restored population; returns 0 on success
+int checkpoint_restore(const char *path, int *m, long long s, long long *generation, long long *alive_count);
+
+// Function that stages a copy of the board and hands it to a dedicated I/O
+// thread, so the compute loop keeps running while the snapshot is written;
+// blocks only if the previous snapshot is still in flight. The writer is
+// started on the first call; returns 0 on success
+int checkpoint_async_write(const char *path, const int *m, long long s, long long generation);
+
+// Function that drains any pending snapshot and stops the writer thread;
+// safe to call even if no async snapshot was ever written
+void checkpoint_async_finish();
+
+#endif
@@ -13,8 +13,21 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "rle.h"
+#include "checkpoint.h"
+#include "history.h"
+#include "render.h"
+#include "prand.h"
+#include "hugealloc.h"
+#include "verify.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 // Whether or not to print matrices (1/0)
 #define PRINT_OUT 0
 
@@ -24,22 +37,47 @@
 #define ALIVE_CHAR	"▉"
 #define DEAD_CHAR	" "
 
+// Cells per column block: three source rows plus the output row of one
+// block stay resident in L2 while the block walks down the board
+#define COL_BLOCK	2048
+
+// Rows per strip in temporal-blocking mode (--tblock); a strip plus its
+// 2k halo rows must fit in cache for the k local steps to pay off
+#define TBLOCK_STRIP	64
+
+// Recent board hashes kept for cycle detection (covers periods up to this)
+#define HASH_HISTORY	64
+
+// Context for streaming RLE pattern cells into the padded grid
+typedef struct RleGrid
+{
+    int 		*m;
+    long long	size;
+} RleGrid;
+
+// Function that writes one alive pattern cell into the grid (clipped to it)
+static void rle_set_cell(void *ctx, long long row, long long col)
+{
+	RleGrid	*g = (RleGrid*) ctx;
+
+	if ( row < g->size && col < g->size )
+		g->m[(row+1)*(g->size+2) + (col+1)] = ALIVE;
+}
+
 // Functions prototypes
-int 		**new_matrix(long long s);
-void 		delete_matrix(int **m, long long s);
-int 		random_number();
-int 		read_neighbor(int **m, long long s, long long i, long long j);
-void 		process_generation(int **from, int **to, long long s);
-void		print_matrix(int **m, long long s);
-long long	cells_alive(int **m, long long s);
+int 		*new_matrix(long long s);
+void 		delete_matrix(int *m);
+void 		fill_ghost_cells(int *m, long long s);
+long long	process_generation(int *from, int *to, long long s, unsigned long long *hash);
+long long	process_generations_blocked(int *from, int *to, long long s, int k);
+void		print_matrix(int *m, long long s);
+void 		print_timing_histogram(double *times, int n);
 double 		GetTime();
 
 // Main funtion
 int main(int argc, char* argv[])
 {
-	srand((unsigned int)time(NULL)); // Random number seeder
-
-	char* usage_msg = "Usage: ./game size generations\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\n";
+	char* usage_msg = "Usage: ./game size generations [seed] [pattern.rle] [--checkpoint interval file] [--restore file] [--tblock k] [--stats n] [--verify] [--history file] [--replay file gen]\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tseed - random seed for reproducible boards (optional)\n\tpattern - RLE pattern file to load instead of a random board (optional)\n\t--checkpoint - snapshot the board to file every interval generations\n\t--restore - resume from a snapshot file instead of generation 0\n\t--tblock - advance k generations per pass over cache-sized row strips\n\t--stats - print one STATS line (generation, seconds, cells/s, GB/s) every n generations\n\t--verify - print one VERIFY line (generation, population, board hash) per generation\n\t--history - append every generation to file as a compressed frame\n\t--replay - start from generation gen of a recorded history instead of generation 0\n\n";
 
 	// Check the arguments
 	if ( argc < 3 )
@@ -61,34 +99,151 @@ int main(int argc, char* argv[])
 		return EXIT_FAILURE;
 	}
 
+	// Seed the random number generator (a fixed seed gives reproducible boards)
+	unsigned int seed = (unsigned int) time(NULL);
+
+	// Optional arguments: seed and pattern are positional, the snapshot
+	// options are flags so they can be combined with either
+	char		*pattern_file = NULL,
+				*checkpoint_file = NULL,
+				*restore_file = NULL,
+				*history_file = NULL,
+				*replay_file = NULL;
+	long long	replay_gen = 0;
+	int			checkpoint_interval = 0,
+				tblock = 0,
+				stats_interval = 0,
+				verify_mode = 0,
+				positionals = 0,
+				a;
+
+	for ( a=3; a<argc; a++ )
+	{
+		if ( strcmp(argv[a], "--checkpoint") == 0 && a+2 < argc )
+		{
+			checkpoint_interval = atoi(argv[a+1]);
+			checkpoint_file = argv[a+2];
+			a += 2;
+		}
+		else if ( strcmp(argv[a], "--restore") == 0 && a+1 < argc )
+			restore_file = argv[++a];
+		else if ( strcmp(argv[a], "--history") == 0 && a+1 < argc )
+			history_file = argv[++a];
+		else if ( strcmp(argv[a], "--replay") == 0 && a+2 < argc )
+		{
+			replay_file = argv[a+1];
+			replay_gen = atoll(argv[a+2]);
+			a += 2;
+		}
+		else if ( strcmp(argv[a], "--tblock") == 0 && a+1 < argc )
+			tblock = atoi(argv[++a]);
+		else if ( strcmp(argv[a], "--stats") == 0 && a+1 < argc )
+			stats_interval = atoi(argv[++a]);
+		else if ( strcmp(argv[a], "--verify") == 0 )
+			verify_mode = 1;
+		else if ( positionals == 0 )
+		{
+			seed = (unsigned int) atoi(argv[a]);
+			positionals++;
+		}
+		else
+		{
+			pattern_file = argv[a];
+			positionals++;
+		}
+	}
+
 	// Program variables
-	int			**matrix = NULL,
-				**next_gen = NULL;
+	int			*matrix = NULL,
+				*next_gen = NULL,
+				*swap = NULL;
 	long long	i,
-				j;
+				j,
+				start_gen = 0,
+				alive_count = 0,
+				hash_gen[HASH_HISTORY];
+	unsigned long long	board_hash = 0,
+				hash_history[HASH_HISTORY];
+	int			hash_slot = 0,
+				cycle_found = 0;
 	double		begin_serial,
- 				end_serial;
+ 				end_serial,
+ 				gen_start,
+ 				*gen_times = NULL;
+	long long	stats_last_gen = 0;
+	double		stats_last_time = 0.0;
 
  	// Timestamp when serial part starts
  	begin_serial = GetTime();
 
 	printf("\nGenerating matrix %dx%d... ", size, size);
 
-	// Create the matrix in the memory
+	// Create both matrices in the memory (reused for the whole run)
 	matrix = new_matrix(size);
+	next_gen = new_matrix(size);
 
 	printf("Done!\n\n");
 
 	printf("Filling out the matrix... ");
 
-    // Randomly fill the matrix
-    for ( i=0; i<size; i++ )
-    	for ( j=0; j<size; j++ )
-    		matrix[i][j] = random_number();
+    if ( restore_file != NULL )
+    {
+    	// Resume from a snapshot instead of generation 0
+    	if ( checkpoint_restore(restore_file, matrix, size, &start_gen, &alive_count) != 0 )
+    	{
+    		printf("Unable to restore the snapshot %s!\n\n", restore_file);
+
+    		return EXIT_FAILURE;
+    	}
+    }
+    else if ( replay_file != NULL )
+    {
+    	// Resume from a recorded history frame instead of generation 0
+    	if ( history_seek(replay_file, matrix, size, replay_gen, &alive_count) != 0 )
+    	{
+    		printf("Unable to replay generation #%lld from %s!\n\n", replay_gen, replay_file);
+
+    		return EXIT_FAILURE;
+    	}
+
+    	start_gen = replay_gen;
+    }
+    else if ( pattern_file != NULL )
+    {
+    	// Decode the RLE pattern straight into the grid (background stays dead)
+    	RleGrid		ctx = { matrix, size };
+    	long long	pat_w = 0,
+    				pat_h = 0;
+
+    	if ( rle_load(pattern_file, &pat_w, &pat_h, rle_set_cell, &ctx) != 0 )
+    	{
+    		printf("Unable to load the pattern %s!\n\n", pattern_file);
+
+    		return EXIT_FAILURE;
+    	}
+
+    	if ( pat_w > size || pat_h > size )
+    		printf("\n[!] Pattern (%lldx%lld) is larger than the board and was clipped.\n", pat_w, pat_h);
+    }
+    else
+    {
+	    // Fill the matrix from the counter-based PRNG (pure hash of
+	    // seed and cell index, no hidden state)
+	    for ( i=0; i<size; i++ )
+	    	for ( j=0; j<size; j++ )
+	    		matrix[(i+1)*(size+2) + (j+1)] = prand_cell(seed, i, j);
+	}
 
     printf("Done!\n");
     printf("\nProcessing generations... ");
 
+    // One timing slot per generation for the exit histogram
+    gen_times = (double*) malloc(generations * sizeof(double));
+
+    // No board states seen yet
+    for ( j=0; j<HASH_HISTORY; j++ )
+    	hash_gen[j] = -1;
+
     // Print out the matrix
     if ( PRINT_OUT )
     {
@@ -97,33 +252,154 @@ int main(int argc, char* argv[])
     	printf("\n");
     }
 
-    // Process the generations
-    for ( i=0; i<generations; i++ )
+    // Open the history file before the first generation is computed
+    if ( history_file != NULL && history_begin(history_file, size, start_gen) != 0 )
     {
-    	// Create a new matrix
-    	next_gen = new_matrix(size);
-    	// Process the next generation
-    	process_generation(matrix, next_gen, size);
+    	printf("Unable to open the history file %s!\n\n", history_file);
 
-    	// Copies next generation to current matrix
-	    delete_matrix(matrix, size);
+    	return EXIT_FAILURE;
+    }
+
+    // The stats window starts where the run does
+    stats_last_gen = start_gen;
+    stats_last_time = GetTime();
+
+    // Process the generations (resuming past the restored ones, if any)
+    for ( i=start_gen; i<generations; )
+    {
+    	int	k_step = 1;
+
+    	gen_start = GetTime();
+
+    	// In temporal-blocking mode one pass advances up to tblock
+    	// generations; stop at the run end and at checkpoint boundaries
+    	// so the snapshots land on the exact generations. Recording a
+    	// history needs every generation, so it keeps the passes at one
+    	if ( tblock > 1 && history_file == NULL )
+    	{
+    		k_step = tblock;
+
+    		if ( k_step > generations - i )
+    			k_step = (int) (generations - i);
+
+    		if ( checkpoint_interval > 0 && k_step > checkpoint_interval - (int) (i % checkpoint_interval) )
+    			k_step = checkpoint_interval - (int) (i % checkpoint_interval);
+    	}
+
+    	if ( k_step > 1 )
+    		// Advance k generations in one pass over overlapped row strips
+    		alive_count = process_generations_blocked(matrix, next_gen, size, k_step);
+    	else
+    	{
+	    	// Copy the wrap rows/columns into the ghost border
+	    	fill_ghost_cells(matrix, size);
+	    	// Process the next generation (the population and board hash are
+	    	// maintained as it is written)
+	    	alive_count = process_generation(matrix, next_gen, size, &board_hash);
+    	}
+
+    	// Swap the matrices
+	    swap = matrix;
 	    matrix = next_gen;
-	    next_gen = NULL;
+	    next_gen = swap;
+
+    	// Spread the pass time over the generations it covered
+    	for ( j=0; j<k_step; j++ )
+    		gen_times[i+j] = (GetTime() - gen_start) / k_step;
+
+    	i += k_step;
+
+    	// One machine-readable throughput line per stats window: generation,
+    	// window seconds, cell updates per second, and the effective bandwidth
+    	// those updates imply (one read and one write per cell)
+    	if ( stats_interval > 0 && i - stats_last_gen >= stats_interval )
+    	{
+    		double		now = GetTime(),
+    					secs = now - stats_last_time;
+    		double		cps = ( secs > 0 ) ? (double) (i - stats_last_gen) * size * size / secs : 0;
+
+    		printf("STATS %lld %.6f %.3e %.3f\n", i, secs, cps, cps * 2.0 * sizeof(int) / 1e9);
+
+    		stats_last_gen = i;
+    		stats_last_time = now;
+    	}
+
+    	// One checksum line per generation for verify.sh; a blocked pass
+    	// only materializes its last generation, so hash the whole board there
+    	if ( verify_mode )
+    	{
+    		if ( k_step > 1 )
+    			board_hash = verify_board_hash(matrix, size);
+
+    		printf("VERIFY %lld %lld %016llx\n", i, alive_count, board_hash);
+    	}
+
+    	// Append this generation's board to the history stream
+    	if ( history_file != NULL )
+    		if ( history_append(matrix, size, i) != 0 )
+    			printf("\n[!] Unable to append generation #%lld to %s.\n", i, history_file);
+
+    	// Look for this state among the recent ones: a match means the board
+    	// entered a cycle, and the remaining full periods can be skipped
+    	// outright since the state repeats exactly. Skipping would silently
+    	// drop snapshots (and VERIFY/STATS lines and history frames), so it
+    	// stays off while checkpointing, verifying, collecting stats or
+    	// recording a history
+    	if ( k_step == 1 && !cycle_found && checkpoint_interval == 0 && !verify_mode && stats_interval == 0 && history_file == NULL )
+    	{
+    		int	h;
+
+    		for ( h=0; h<HASH_HISTORY; h++ )
+    			if ( hash_gen[h] >= 0 && hash_history[h] == board_hash )
+    			{
+    				long long	period = i - hash_gen[h],
+    							skipped = (generations - i) - (generations - i) % period;
+
+    				printf("cycle of period %lld at generation #%lld, skipping %lld... ", period, i, skipped);
+
+    				// The skipped generations cost nothing
+    				for ( j=0; j<skipped; j++ )
+    					gen_times[i+j] = 0.0;
+
+    				i += skipped;
+    				cycle_found = 1;
+
+    				break;
+    			}
+
+    		hash_history[hash_slot] = board_hash;
+    		hash_gen[hash_slot] = i;
+    		hash_slot = (hash_slot + 1) % HASH_HISTORY;
+    	}
+
+    	// Periodically snapshot the board so the run can be resumed later;
+    	// the staged copy is written by the I/O thread while the next
+    	// generations compute
+    	if ( checkpoint_interval > 0 && i % checkpoint_interval == 0 )
+    		if ( checkpoint_async_write(checkpoint_file, matrix, size, i) != 0 )
+    			printf("\n[!] Unable to stage the snapshot %s at generation #%lld.\n", checkpoint_file, i);
 
     	// Print it out
     	if ( PRINT_OUT )
 	    {
-	    	printf("Generation #%d:\n\n", (int) i+1);
+	    	printf("Generation #%d (%lld alive):\n\n", (int) i, alive_count);
 	    	print_matrix(matrix, size);
 	    	printf("\n");
 	    }
     }
 
+    // Wait for the last snapshot to reach disk before reporting
+    checkpoint_async_finish();
+
+    // Seal the history stream with its keyframe index
+    history_finish();
+
     printf("Done!\n");
-    printf("\n-> Alive cells at the generation #%d: %lld\n\n", generations, cells_alive(matrix, size));
+    printf("\n-> Alive cells at the generation #%d: %lld\n\n", generations, alive_count);
 
     // Delete the matrices from the memory
-    delete_matrix(matrix, size);
+    delete_matrix(matrix);
+    delete_matrix(next_gen);
 
     // Timestamp when serial part ends
  	end_serial = GetTime();
@@ -135,147 +411,409 @@ int main(int argc, char* argv[])
  	printf("- Serial:\t%.3f seconds\n", (double) time_serial);
  	printf("- Total:\t%.3f seconds\n", (double) time_serial);
 
+ 	if ( generations > start_gen )
+ 	{
+ 		printf("\nPer-generation time histogram:\n\n");
+ 		print_timing_histogram(&gen_times[start_gen], (int) (generations - start_gen));
+ 	}
+ 	free(gen_times);
+
 	// End of the program
 	return EXIT_SUCCESS;
 }
 
 // Function that generate a matrix dinamycally
-int **new_matrix(long long s)
+int *new_matrix(long long s)
 {
-	// Create the matrix in the memory
-	long long	i;
-	int 		**m;
+	// Create the matrix in the memory as one contiguous block (row-major)
+	// with a one-cell ghost border on every side
+	int 		*m;
 
-	m = (int**) malloc(s * sizeof(int*));
-	
-	for ( i=0; i<s; i++ )
-        m[i] = (int*) malloc(s * sizeof(int));
+	m = (int*) huge_alloc((s+2) * (s+2) * sizeof(int));
 
     return m;
 }
 
 // Function that removes a matrix from the memory
-void delete_matrix(int **m, long long s)
+void delete_matrix(int *m)
 {
 	if ( m != NULL )
 	{
-		int	i;
-
-		for ( i=0; i<s; i++ )
-		{
-			// Delete row in the matrix
-			free(m[i]);
-			m[i] = NULL;
-		}
-
 		// Delete the whole matrix
-		free(m);
+		huge_free(m);
 		m = NULL;
 	}
 }
 
-// Function that generate and return a random number 0 or 1
-int random_number()
+
+// Function that copies the wrap rows/columns into the ghost border
+void fill_ghost_cells(int *m, long long s)
 {
-    if (rand() % 2 == 0)
-    	return ALIVE;
-    else
-    	return DEAD;
+	long long	k,
+				p = s+2;
+
+	// Wrap rows: top ghost row mirrors the last row, bottom ghost row the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[0*p + k] = m[s*p + k];
+		m[(s+1)*p + k] = m[1*p + k];
+	}
+
+	// Wrap columns: left ghost column mirrors the last column, right the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[k*p + 0] = m[k*p + s];
+		m[k*p + (s+1)] = m[k*p + 1];
+	}
+
+	// Wrap the four corners
+	m[0*p + 0] = m[s*p + s];
+	m[0*p + (s+1)] = m[s*p + 1];
+	m[(s+1)*p + 0] = m[1*p + s];
+	m[(s+1)*p + (s+1)] = m[1*p + 1];
 }
 
-// Function that reads a neighbor
-int read_neighbor(int **m, long long s, long long i, long long j)
+#if defined(__x86_64__)
+// Function that process columns j0..j1 of one interior row, 8 cells at a
+// time, using AVX2; returns the number of alive cells written
+__attribute__((target("avx2")))
+static long long process_row_avx2(int *up, int *mid, int *down, int *out, long long j0, long long j1)
 {
-	if ( i < 0 )
-		i = s - 1;
-	else if ( i == s )
-		i = 0;
+	long long	j = j0,
+				alives = 0;
+	__m256i		acc = _mm256_setzero_si256(),
+				two = _mm256_set1_epi32(2),
+				three = _mm256_set1_epi32(3),
+				one = _mm256_set1_epi32(ALIVE);
+
+	// Compute 8 neighbor counts per iteration with packed adds,
+	// then apply the rules with compares and blends
+	for ( ; j+7 <= j1; j += 8 )
+	{
+		__m256i	sum = _mm256_add_epi32(
+					_mm256_loadu_si256((__m256i const*)&up[j-1]),
+					_mm256_loadu_si256((__m256i const*)&up[j]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&up[j+1]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&mid[j-1]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&mid[j+1]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&down[j-1]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&down[j]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&down[j+1]));
+
+		__m256i	center = _mm256_loadu_si256((__m256i const*)&mid[j]);
+		__m256i	birth = _mm256_cmpeq_epi32(sum, three);
+		__m256i	survive = _mm256_and_si256(_mm256_cmpeq_epi32(sum, two),
+					_mm256_cmpeq_epi32(center, one));
+
+		// Turn the compare masks back into ALIVE/DEAD ints
+		__m256i	next = _mm256_and_si256(_mm256_or_si256(birth, survive), one);
+		_mm256_storeu_si256((__m256i*)&out[j], next);
+
+		// Accumulate the population as we write
+		acc = _mm256_add_epi32(acc, next);
+	}
+
+	// Reduce the per-lane population counters
+	{
+		int	lanes[8];
+
+		_mm256_storeu_si256((__m256i*)lanes, acc);
+		alives = (long long) lanes[0] + lanes[1] + lanes[2] + lanes[3]
+				+ lanes[4] + lanes[5] + lanes[6] + lanes[7];
+	}
+
+	// Scalar tail for the last few columns of the block
+	for ( ; j<=j1; j++ )
+	{
+		int	alive_neighbors =
+				up[j-1] + up[j] + up[j+1] +
+				mid[j-1] + mid[j+1] +
+				down[j-1] + down[j] + down[j+1];
+
+		if ( alive_neighbors == 3 || ( alive_neighbors == 2 && mid[j] == ALIVE ) )
+			out[j] = ALIVE;
+		else
+			out[j] = DEAD;
 
-	if ( j < 0 )
-		j = s - 1;
-	else if ( j == s )
-		j = 0;
+		alives += out[j];
+	}
 
-	return m[i][j];
+	return alives;
 }
+#endif
 
-// Function that process the next generation
-void process_generation(int **from, int **to, long long s)
+// Function that process the next generation; returns the number of alive
+// cells in the new generation, counted while it is written. The traversal
+// is blocked into COL_BLOCK-wide column strips so the three source rows a
+// strip touches stay cached while the strip walks down the board
+long long process_generation(int *from, int *to, long long s, unsigned long long *hash)
 {
 	long long	i,
 				j,
-				alive_neighbors = 0;
+				j0,
+				j1,
+				p = s+2,
+				alive_neighbors = 0,
+				alives = 0;
+	unsigned long long	h = 0;
+
+#if defined(__x86_64__)
+	// Detect AVX2 once at runtime; without it we fall through to the scalar path
+	static int	use_avx2 = -1;
+
+	if ( use_avx2 < 0 )
+		use_avx2 = __builtin_cpu_supports("avx2");
+
+	if ( use_avx2 )
+	{
+		for ( j0=1; j0<=s; j0+=COL_BLOCK )
+		{
+			j1 = ( j0+COL_BLOCK-1 <= s ) ? j0+COL_BLOCK-1 : s;
+
+			for ( i=1; i<=s; i++ )
+			{
+				alives += process_row_avx2(&from[(i-1)*p], &from[i*p], &from[(i+1)*p], &to[i*p], j0, j1);
+				h ^= verify_row_hash(&to[i*p], i, j0, j1);
+			}
+		}
+
+		*hash = h;
 
-	// Go through the matrix
-	for ( i=0; i<s; i++ )
-		for ( j=0; j<s; j++ )
+		return alives;
+	}
+#endif
+
+	// Go through the interior of the matrix (no wrap checks needed),
+	// one column block at a time
+	for ( j0=1; j0<=s; j0+=COL_BLOCK )
+	{
+		j1 = ( j0+COL_BLOCK-1 <= s ) ? j0+COL_BLOCK-1 : s;
+
+		for ( i=1; i<=s; i++ )
 		{
-			// Calculate the number of neighbors alive
-			alive_neighbors = 
-				read_neighbor(from, s, i-1,	j-1)	+ // Northwest
-                read_neighbor(from, s, i-1,	j)		+ // North
-                read_neighbor(from, s, i-1,	j+1)	+ // Northeast
-                read_neighbor(from, s, i,	j-1)	+ // West
-                read_neighbor(from, s, i,	j+1)	+ // East
-                read_neighbor(from, s, i+1,	j-1)	+ // Southwest
-                read_neighbor(from, s, i+1,	j)		+ // South
-                read_neighbor(from, s, i+1,	j+1);	  // Southwest
-
-            // Apply the rules
-            
-            if ( from[i][j] == ALIVE )
-            {
-                if ( alive_neighbors == 2 || alive_neighbors == 3 )
-                    to[i][j] = ALIVE;
-                else
-                    to[i][j] = DEAD;
-            }
-            else
-            {
-                if ( alive_neighbors == 3 )
-                    to[i][j] = ALIVE;
-                else
-                    to[i][j] = DEAD;
-            }
+			for ( j=j0; j<=j1; j++ )
+			{
+				// Calculate the number of neighbors alive
+				alive_neighbors = 
+					from[(i-1)*p + (j-1)]	+ // Northwest
+					from[(i-1)*p + j]		+ // North
+					from[(i-1)*p + (j+1)]	+ // Northeast
+					from[i*p + (j-1)]		+ // West
+					from[i*p + (j+1)]		+ // East
+					from[(i+1)*p + (j-1)]	+ // Southwest
+					from[(i+1)*p + j]		+ // South
+					from[(i+1)*p + (j+1)];	  // Southeast
+
+				// Apply the rules
+
+				if ( from[i*p + j] == ALIVE )
+				{
+					if ( alive_neighbors == 2 || alive_neighbors == 3 )
+						to[i*p + j] = ALIVE;
+					else
+						to[i*p + j] = DEAD;
+				}
+				else
+				{
+					if ( alive_neighbors == 3 )
+						to[i*p + j] = ALIVE;
+					else
+						to[i*p + j] = DEAD;
+				}
+
+				// Accumulate the population as we write
+				alives += to[i*p + j];
+			}
+
+			h ^= verify_row_hash(&to[i*p], i, j0, j1);
 		}
+	}
+
+	*hash = h;
+
+	return alives;
 }
 
-// Function that print out a matrix
-void print_matrix(int **m, long long s)
+// Function that process one scratch row (columns 1..s) during a
+// temporal-blocking sub-step
+static void tblock_row(int *up, int *mid, int *down, int *out, long long s)
 {
-	long long	i,
-				j;
+	long long	j;
 
-	for ( i=0; i<s; i++ )
-    {
-    	for ( j=0; j<s; j++ )
-    		if ( m[i][j] == ALIVE )
-    			printf(ALIVE_CHAR);
-    		else
-    			printf(DEAD_CHAR);
+#if defined(__x86_64__)
+	static int	use_avx2 = -1;
 
-    	printf("\n");
-    }
+	if ( use_avx2 < 0 )
+		use_avx2 = __builtin_cpu_supports("avx2");
+
+	if ( use_avx2 )
+	{
+		process_row_avx2(up, mid, down, out, 1, s);
+
+		return;
+	}
+#endif
+
+	for ( j=1; j<=s; j++ )
+	{
+		int	alive_neighbors =
+				up[j-1] + up[j] + up[j+1] +
+				mid[j-1] + mid[j+1] +
+				down[j-1] + down[j] + down[j+1];
+
+		if ( alive_neighbors == 3 || ( alive_neighbors == 2 && mid[j] == ALIVE ) )
+			out[j] = ALIVE;
+		else
+			out[j] = DEAD;
+	}
 }
 
-// Function that calculates the amount of alive cells in a grid
-long long cells_alive(int **m, long long s)
+// Function that advance the whole board k generations in one pass using
+// overlapped row strips: each strip is copied into a scratch grid with a
+// k-row halo on both sides, stepped k times locally (the valid region
+// shrinking one row per step), and the settled core written back. The
+// halo rows are recomputed redundantly, but the strip stays cached for
+// all k steps, so DRAM traffic drops by roughly a factor of k
+long long process_generations_blocked(int *from, int *to, long long s, int k)
 {
-	long long	i,
+	long long	p = s+2,
+				max_rows = TBLOCK_STRIP + 2*k,
+				r0,
+				t,
 				j,
 				alives = 0;
+	int			*sa,
+				*sb,
+				*sswap;
+
+	sa = (int*) malloc(max_rows * p * sizeof(int));
+	sb = (int*) malloc(max_rows * p * sizeof(int));
 
-	for ( i=0; i<s; i++ )
-		for ( j=0; j<s; j++ )
-			if ( m[i][j] == ALIVE )
-				alives++;
+	for ( r0=1; r0<=s; r0+=TBLOCK_STRIP )
+	{
+		long long	strip_h = ( r0+TBLOCK_STRIP-1 <= s ) ? TBLOCK_STRIP : s-r0+1,
+					rows = strip_h + 2*k,
+					v0 = 0,
+					v1 = rows-1;
+		int			step;
+
+		// Copy the strip and its halo rows out of the current board,
+		// wrapping the row indices around the torus
+		for ( t=0; t<rows; t++ )
+		{
+			long long	src = ((r0 - k + t - 1) % s + s) % s + 1;
+
+			memcpy(&sa[t*p], &from[src*p], p * sizeof(int));
+		}
+
+		// Step the strip k times; every step consumes one halo row on
+		// each side, so after k steps the core rows are k generations on
+		for ( step=0; step<k; step++ )
+		{
+			// Wrap the columns of the still-valid rows
+			for ( t=v0; t<=v1; t++ )
+			{
+				sa[t*p + 0] = sa[t*p + s];
+				sa[t*p + (s+1)] = sa[t*p + 1];
+			}
+
+			for ( t=v0+1; t<=v1-1; t++ )
+				tblock_row(&sa[(t-1)*p], &sa[t*p], &sa[(t+1)*p], &sb[t*p], s);
+
+			v0++;
+			v1--;
+
+			sswap = sa;
+			sa = sb;
+			sb = sswap;
+		}
+
+		// Write the settled core back and count its population
+		for ( t=k; t<k+strip_h; t++ )
+		{
+			memcpy(&to[(r0 + t - k)*p + 1], &sa[t*p + 1], s * sizeof(int));
+
+			for ( j=1; j<=s; j++ )
+				alives += sa[t*p + j];
+		}
+	}
+
+	free(sa);
+	free(sb);
 
 	return alives;
 }
 
-// Function that gets the current timestamp
+// Function that print out a matrix (buffered; diffed against the previous
+// frame when stdout is a terminal)
+void print_matrix(int *m, long long s)
+{
+	render_frame(m, s, ALIVE_CHAR, DEAD_CHAR);
+}
+
+// Function that prints a histogram of the per-generation times
+void print_timing_histogram(double *times, int n)
+{
+	double	min_t = times[0],
+			max_t = times[0],
+			width;
+	int		buckets[10] = {0},
+			i,
+			b,
+			biggest = 1;
+
+	for ( i=0; i<n; i++ )
+	{
+		if ( times[i] < min_t )
+			min_t = times[i];
+		if ( times[i] > max_t )
+			max_t = times[i];
+	}
+
+	width = (max_t - min_t) / 10.0;
+
+	// Degenerate case: every generation took the same time
+	if ( width <= 0.0 )
+	{
+		printf("- %.6f s: %d generation(s)\n", min_t, n);
+
+		return;
+	}
+
+	for ( i=0; i<n; i++ )
+	{
+		b = (int) ((times[i] - min_t) / width);
+
+		if ( b > 9 )
+			b = 9;
+
+		buckets[b]++;
+	}
+
+	for ( b=0; b<10; b++ )
+		if ( buckets[b] > biggest )
+			biggest = buckets[b];
+
+	for ( b=0; b<10; b++ )
+	{
+		printf("- %.6f-%.6f s: %6d |", min_t + b*width, min_t + (b+1)*width, buckets[b]);
+
+		for ( i=0; i<(buckets[b]*40)/biggest; i++ )
+			printf("#");
+
+		printf("\n");
+	}
+}
+
+// Function that gets the current timestamp (monotonic wall clock; the old
+// clock()-based version summed CPU time across threads and made the parallel
+// numbers meaningless)
 double GetTime()
 {
-	return (double) clock() / CLOCKS_PER_SEC;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1000000000.0;
 }
 
@@ -0,0 +1,416 @@
+/* File:    game_cuda.cu
+ * Purpose: Run the Game of Life on a GPU using a bit-packed board.
+ * Compile: make -f make_game_cuda   (needs the CUDA toolkit)
+ * Run:     ./game_cuda <grid size> <number of generations>
+ * Input:   None
+ * Output:  Resultant generation, number of alive cells, and time spent doing calculations.
+ *
+ * Notes:
+ *  1.  Time given in seconds.
+ *  2.  Same board layout and full-adder update as game_bit.c: 1 bit per cell,
+ *      64 cells per word, rows padded to whole words.
+ *  3.  The board lives in device memory for the whole run; only the per-generation
+ *      population count (8 bytes) and requested snapshots are copied back.
+ *  4.  Each thread block stages a tile of words plus its one-word halo in shared
+ *      memory, so every board word is read from global memory once per generation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <cuda_runtime.h>
+
+#include "prand.h"
+
+// Whether or not to print matrices (1/0)
+#define PRINT_OUT 0
+
+// Cell definitions (must be integers and char*)
+#define ALIVE 		1
+#define DEAD		0
+#define ALIVE_CHAR	"▉"
+#define DEAD_CHAR	" "
+
+// Bits per board word
+#define WORD_BITS	64
+
+// Thread block shape: each thread updates one word (64 cells)
+#define TILE_ROWS	8
+#define TILE_WORDS	32
+
+// Abort on any CUDA error; the engines treat allocation failure the same way
+#define CUDA_CHECK(call)												\
+	do {																\
+		cudaError_t err_ = (call);										\
+		if ( err_ != cudaSuccess )										\
+		{																\
+			printf("\nCUDA error at %s:%d: %s\n", __FILE__, __LINE__,	\
+					cudaGetErrorString(err_));							\
+			exit(EXIT_FAILURE);											\
+		}																\
+	} while (0)
+
+// Functions prototypes
+uint64_t	*new_board(long long s);
+void 		delete_board(uint64_t *m);
+long long	words_per_row(long long s);
+void		print_board(uint64_t *m, long long s);
+double 		GetTime();
+
+// Function that return the number of 64-bit words per board row
+long long words_per_row(long long s)
+{
+	return (s + WORD_BITS - 1) / WORD_BITS;
+}
+
+// Function that build the west-neighbor bits of a row word (torus wrap);
+// when this is word 0 of the row, 'left' already holds word w-1
+__device__ uint64_t west_bits(uint64_t left, uint64_t mid, int first_word, long long last_bits)
+{
+	uint64_t	v = mid << 1;
+
+	if ( first_word )
+		v |= (left >> (last_bits-1)) & 1ULL; // Column s-1 wraps to the west of column 0
+	else
+		v |= left >> (WORD_BITS-1);
+
+	return v;
+}
+
+// Function that build the east-neighbor bits of a row word (torus wrap);
+// when this is word w-1 of the row, 'right' already holds word 0
+__device__ uint64_t east_bits(uint64_t right, uint64_t mid, int last_word, long long last_bits)
+{
+	uint64_t	v = mid >> 1;
+
+	if ( last_word )
+		v |= (right & 1ULL) << (last_bits-1); // Column 0 wraps to the east of column s-1
+	else
+		v |= right << (WORD_BITS-1);
+
+	return v;
+}
+
+// Kernel that process the next generation, one word (64 cells) per thread,
+// and accumulates the new population into *alives
+__global__ void step_kernel(const uint64_t *from, uint64_t *to, long long s,
+							long long w, long long last_bits, unsigned long long *alives)
+{
+	// Tile of board words plus a one-word halo on every side
+	__shared__ uint64_t tile[TILE_ROWS+2][TILE_WORDS+2];
+	__shared__ unsigned long long block_alives;
+
+	long long	i = (long long) blockIdx.y * TILE_ROWS + threadIdx.y,
+				k = (long long) blockIdx.x * TILE_WORDS + threadIdx.x;
+	int			ti = threadIdx.y + 1,
+				tk = threadIdx.x + 1;
+	int			in_board = ( i < s && k < w );
+
+	if ( threadIdx.x == 0 && threadIdx.y == 0 )
+		block_alives = 0;
+
+	// Stage this thread's word and, on the tile edges, the halo words;
+	// rows and words wrap around the torus. A tile on the board's south/east
+	// border can be ragged, so its last in-board thread loads that halo too.
+	if ( in_board )
+	{
+		long long	up = (i == 0) ? s-1 : i-1,
+					down = (i == s-1) ? 0 : i+1,
+					west = (k == 0) ? w-1 : k-1,
+					east = (k == w-1) ? 0 : k+1;
+		int			load_top = ( threadIdx.y == 0 ),
+					load_bottom = ( threadIdx.y == TILE_ROWS-1 || i == s-1 ),
+					load_west = ( threadIdx.x == 0 ),
+					load_east = ( threadIdx.x == TILE_WORDS-1 || k == w-1 );
+
+		tile[ti][tk] = from[i*w + k];
+
+		if ( load_top )
+			tile[ti-1][tk] = from[up*w + k];
+
+		if ( load_bottom )
+			tile[ti+1][tk] = from[down*w + k];
+
+		if ( load_west )
+			tile[ti][tk-1] = from[i*w + west];
+
+		if ( load_east )
+			tile[ti][tk+1] = from[i*w + east];
+
+		if ( load_top && load_west )
+			tile[ti-1][tk-1] = from[up*w + west];
+
+		if ( load_top && load_east )
+			tile[ti-1][tk+1] = from[up*w + east];
+
+		if ( load_bottom && load_west )
+			tile[ti+1][tk-1] = from[down*w + west];
+
+		if ( load_bottom && load_east )
+			tile[ti+1][tk+1] = from[down*w + east];
+	}
+
+	__syncthreads();
+
+	unsigned long long my_alives = 0;
+
+	if ( in_board )
+	{
+		int	first_word = ( k == 0 ),
+			last_word = ( k == w-1 );
+
+		// Gather the eight neighbor bit-vectors of the 64 cells in this word
+		uint64_t	nw = west_bits(tile[ti-1][tk-1], tile[ti-1][tk], first_word, last_bits),
+					n  = tile[ti-1][tk],
+					ne = east_bits(tile[ti-1][tk+1], tile[ti-1][tk], last_word, last_bits),
+					ww = west_bits(tile[ti][tk-1], tile[ti][tk], first_word, last_bits),
+					ee = east_bits(tile[ti][tk+1], tile[ti][tk], last_word, last_bits),
+					sw = west_bits(tile[ti+1][tk-1], tile[ti+1][tk], first_word, last_bits),
+					ss = tile[ti+1][tk],
+					se = east_bits(tile[ti+1][tk+1], tile[ti+1][tk], last_word, last_bits),
+					center = tile[ti][tk];
+
+		// Full-adder reduction: per-row 2-bit partial sums...
+		uint64_t	sum_a = nw ^ n ^ ne,
+					car_a = (nw & n) | (nw & ne) | (n & ne),
+					sum_b = ww ^ ee,
+					car_b = ww & ee,
+					sum_c = sw ^ ss ^ se,
+					car_c = (sw & ss) | (sw & se) | (ss & se);
+
+		// ...then add the three partials into count bits (bit2 saturates at >=4)
+		uint64_t	partial = sum_a ^ sum_b,
+					bit0 = partial ^ sum_c,
+					car_ones = (sum_a & sum_b) | (partial & sum_c),
+					t0 = car_a ^ car_b,
+					t1 = car_a & car_b,
+					t2 = t0 ^ car_c,
+					t3 = (t0 & car_c) | t1,
+					bit1 = t2 ^ car_ones,
+					bit2 = t3 | (t2 & car_ones);
+
+		// Apply the rules: alive iff count==3, or count==2 and already alive
+		uint64_t	result = ~bit2 & bit1 & (bit0 | center);
+
+		// Clear the padding bits of the last word
+		if ( last_word && last_bits < WORD_BITS )
+			result &= (1ULL << last_bits) - 1;
+
+		to[i*w + k] = result;
+
+		my_alives = (unsigned long long) __popcll(result);
+	}
+
+	// Reduce the population inside the block, then once into global memory
+	atomicAdd(&block_alives, my_alives);
+
+	__syncthreads();
+
+	if ( threadIdx.x == 0 && threadIdx.y == 0 )
+		atomicAdd(alives, block_alives);
+}
+
+// Main funtion
+int main(int argc, char* argv[])
+{
+	const char* usage_msg = "Usage: ./game_cuda size generations [seed]\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tseed - random seed for reproducible boards (optional)\n\n";
+
+	// Check the arguments
+	if ( argc < 3 )
+	{
+		printf("%s", usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Get the arguments
+	int	size = atoi(argv[1]),
+		generations = atoi(argv[2]);
+
+	// If no valid arguments were provided
+	if ( size == 0 || generations == 0 )
+	{
+		printf("%s", usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Seed the random number generator (a fixed seed gives reproducible boards)
+	unsigned int seed = (unsigned int) time(NULL);
+
+	if ( argc > 3 )
+		seed = (unsigned int) atoi(argv[3]);
+
+	// Program variables
+	uint64_t	*board = NULL,
+				*d_board = NULL,
+				*d_next_gen = NULL,
+				*d_swap = NULL;
+	long long	i,
+				j,
+				w = words_per_row(size),
+				last_bits = size - (w-1)*WORD_BITS;
+	unsigned long long	alive_count = 0,
+						*d_alives = NULL;
+	double		begin_serial,
+ 				end_serial,
+ 				begin_parallel,
+ 				end_parallel;
+
+ 	// Timestamp when serial part starts
+ 	begin_serial = GetTime();
+
+	printf("\nGenerating board %dx%d (%lld words per row)... ", size, size, w);
+
+	// Create the host board (only used to fill and, with PRINT_OUT, to print)
+	board = new_board(size);
+
+	printf("Done!\n\n");
+
+	printf("Filling out the board... ");
+
+    // Fill the board from the counter-based PRNG, one bit per cell
+    for ( i=0; i<size; i++ )
+    	for ( j=0; j<size; j++ )
+    		if ( prand_cell(seed, i, j) == ALIVE )
+    			board[i*w + j/WORD_BITS] |= 1ULL << (j % WORD_BITS);
+
+    printf("Done!\n");
+    printf("\nProcessing generations... ");
+
+    // Print out the board
+    if ( PRINT_OUT )
+    {
+    	printf("\n\nGrid %dx%d:\n\n", size, size);
+    	print_board(board, size);
+    	printf("\n");
+    }
+
+    // Timestamp when parallel part starts
+    begin_parallel = GetTime();
+
+    // Create both boards on the device and upload the start state once;
+    // the board stays resident there for the whole run
+    size_t board_bytes = (size_t) size * w * sizeof(uint64_t);
+
+    CUDA_CHECK( cudaMalloc(&d_board, board_bytes) );
+    CUDA_CHECK( cudaMalloc(&d_next_gen, board_bytes) );
+    CUDA_CHECK( cudaMalloc(&d_alives, sizeof(unsigned long long)) );
+    CUDA_CHECK( cudaMemcpy(d_board, board, board_bytes, cudaMemcpyHostToDevice) );
+
+    dim3	block(TILE_WORDS, TILE_ROWS);
+    dim3	grid((unsigned int) ((w + TILE_WORDS-1) / TILE_WORDS),
+    			 (unsigned int) ((size + TILE_ROWS-1) / TILE_ROWS));
+
+    // Process the generations
+    for ( i=0; i<generations; i++ )
+    {
+    	// Process the next generation; the kernel also counts the population
+    	CUDA_CHECK( cudaMemsetAsync(d_alives, 0, sizeof(unsigned long long)) );
+
+    	step_kernel<<<grid, block>>>(d_board, d_next_gen, size, w, last_bits, d_alives);
+    	CUDA_CHECK( cudaGetLastError() );
+
+    	// Swap the boards
+	    d_swap = d_board;
+	    d_board = d_next_gen;
+	    d_next_gen = d_swap;
+
+    	// Print it out (snapshot copied back on request only)
+    	if ( PRINT_OUT )
+	    {
+	    	CUDA_CHECK( cudaMemcpy(board, d_board, board_bytes, cudaMemcpyDeviceToHost) );
+	    	printf("Generation #%d:\n\n", (int) i+1);
+	    	print_board(board, size);
+	    	printf("\n");
+	    }
+    }
+
+    // Only the final population crosses back over the bus
+    CUDA_CHECK( cudaMemcpy(&alive_count, d_alives, sizeof(unsigned long long),
+    						cudaMemcpyDeviceToHost) );
+
+    // Timestamp when parallel part ends
+    end_parallel = GetTime();
+
+    printf("Done!\n");
+    printf("\n-> Alive cells at the generation #%d: %llu\n\n", generations, alive_count);
+
+    // Delete the boards from the memory
+    CUDA_CHECK( cudaFree(d_board) );
+    CUDA_CHECK( cudaFree(d_next_gen) );
+    CUDA_CHECK( cudaFree(d_alives) );
+    delete_board(board);
+
+    // Timestamp when serial part ends
+ 	end_serial = GetTime();
+
+ 	double	time_parallel = end_parallel - begin_parallel,
+ 			time_serial = (end_serial - begin_serial) - time_parallel;
+ 	// Show statistics about execution time
+ 	printf("____________________________________________________\n\n");
+ 	printf("Execution time (by part):\n\n");
+ 	printf("- Serial:\t%.3f seconds\n", (double) time_serial);
+ 	printf("- Parallel:\t%.3f seconds\n", (double) time_parallel);
+ 	printf("- Total:\t%.3f seconds\n", (double) (time_serial + time_parallel));
+
+	// End of the program
+	return EXIT_SUCCESS;
+}
+
+// Function that generate a bit-packed board dinamycally
+uint64_t *new_board(long long s)
+{
+	// Create the board in the memory as one contiguous block (row-major),
+	// cleared so the padding bits of the last word start at zero
+	long long	w = words_per_row(s);
+	uint64_t	*m;
+
+	m = (uint64_t*) calloc(s * w, sizeof(uint64_t));
+
+    return m;
+}
+
+// Function that removes a board from the memory
+void delete_board(uint64_t *m)
+{
+	if ( m != NULL )
+	{
+		// Delete the whole board
+		free(m);
+		m = NULL;
+	}
+}
+
+
+// Function that print out a board
+void print_board(uint64_t *m, long long s)
+{
+	long long	i,
+				j,
+				w = words_per_row(s);
+
+	for ( i=0; i<s; i++ )
+    {
+    	for ( j=0; j<s; j++ )
+    		if ( (m[i*w + j/WORD_BITS] >> (j % WORD_BITS)) & 1ULL )
+    			printf(ALIVE_CHAR);
+    		else
+    			printf(DEAD_CHAR);
+
+    	printf("\n");
+    }
+}
+
+// Function that gets the current timestamp (monotonic wall clock; the old
+// clock()-based version summed CPU time across threads and made the parallel
+// numbers meaningless)
+double GetTime()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1000000000.0;
+}
@@ -0,0 +1,469 @@
+/* File:    game_hashlife.c
+ * Purpose: Run the Game of Life with the HashLife algorithm (quadtree + memoization).
+ * Compile: make -f make_game_hashlife
+ * Run:     ./game_hashlife <grid size> <number of generations>
+ * Input:   None
+ * Output:  Resultant generation, number of alive cells, and time spent doing calculations.
+ *
+ * Notes:
+ *  1.  Time given in seconds.
+ *  2.  The board is a hash-consed quadtree: identical regions are stored once
+ *      and their evolved results are memoized, so structured or periodic
+ *      patterns evolve in time roughly proportional to the number of distinct
+ *      regions, not the number of generations.
+ *  3.  A level-k macrocell can be advanced 2^(k-2) generations in one memoized
+ *      step; arbitrary generation counts are run by binary decomposition.
+ *  4.  Unlike the other engines, HashLife computes on an unbounded dead plane,
+ *      not a torus: patterns may grow past the original board frame, so
+ *      populations can differ from the wrap-around engines once the border is
+ *      reached.
+ *  5.  Memoized nodes are never collected; very chaotic boards will grow the
+ *      node table. Structured long-horizon runs are the intended workload.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "prand.h"
+
+// Whether or not to print matrices (1/0)
+#define PRINT_OUT 0
+
+// Cell definitions (must be integers and char*)
+#define ALIVE 		1
+#define DEAD		0
+#define ALIVE_CHAR	"▉"
+#define DEAD_CHAR	" "
+
+// Number of buckets in the node hash table (power of two)
+#define HASH_BUCKETS (1 << 22)
+
+// Marker for "no partial result cached"
+#define NO_PARTIAL -1
+
+// A quadtree macrocell: level 0 is a single cell, level k covers 2^k x 2^k
+typedef struct Node
+{
+	struct Node	*nw,
+				*ne,
+				*sw,
+				*se;
+	struct Node	*result;		// Center advanced 2^(level-2) generations
+	struct Node	*partial;		// Center advanced 2^partial_j generations
+	struct Node	*hash_next;
+	long long	pop;
+	int			level;
+	int			partial_j;
+} Node;
+
+// Functions prototypes
+Node 		*find_node(Node *nw, Node *ne, Node *sw, Node *se);
+Node 		*empty_node(int level);
+Node 		*expand(Node *n);
+int 		is_padded(Node *n);
+Node 		*life4x4(Node *n);
+Node 		*result(Node *n);
+Node 		*successor(Node *n, int j);
+Node 		*build_tree(char *cells, long long size, int level, long long top, long long left);
+Node 		*advance(Node *root, long long generations);
+void		print_tree(Node *n, long long s);
+int 		get_cell(Node *n, long long i, long long j);
+double 		GetTime();
+
+// The two canonical single cells and the node hash table
+Node		*leaf_alive = NULL,
+			*leaf_dead = NULL;
+Node		**hash_table = NULL;
+
+// Main funtion
+int main(int argc, char* argv[])
+{
+	char* usage_msg = "Usage: ./game_hashlife size generations [seed]\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tseed - random seed for reproducible boards (optional)\n\n";
+
+	// Check the arguments
+	if ( argc < 3 )
+	{
+		printf(usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Get the arguments
+	int	size = atoi(argv[1]);
+	long long	generations = atoll(argv[2]);
+
+	// If no valid arguments were provided
+	if ( size == 0 || generations == 0 )
+	{
+		printf(usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Seed the random number generator (a fixed seed gives reproducible boards)
+	unsigned int seed = (unsigned int) time(NULL);
+
+	if ( argc > 3 )
+		seed = (unsigned int) atoi(argv[3]);
+
+	// Program variables
+	Node		*root = NULL;
+	char		*cells = NULL;
+	long long	i,
+				j;
+	int			level = 2;
+	double		begin_serial,
+ 				end_serial;
+
+ 	// Timestamp when serial part starts
+ 	begin_serial = GetTime();
+
+	// Create the node hash table and the two canonical cells
+	hash_table = (Node**) calloc(HASH_BUCKETS, sizeof(Node*));
+	leaf_alive = (Node*) calloc(1, sizeof(Node));
+	leaf_alive->pop = 1;
+	leaf_alive->partial_j = NO_PARTIAL;
+	leaf_dead = (Node*) calloc(1, sizeof(Node));
+	leaf_dead->partial_j = NO_PARTIAL;
+
+	// Smallest quadtree level that covers the board
+	while ( (1LL << level) < size )
+		level++;
+
+	printf("\nGenerating matrix %dx%d (quadtree level %d)... ", size, size, level);
+
+	cells = (char*) calloc((long long) size * size, sizeof(char));
+
+	printf("Done!\n\n");
+
+	printf("Filling out the matrix... ");
+
+    // Fill the matrix from the counter-based PRNG (pure hash of
+    // seed and cell index, no hidden state)
+    for ( i=0; i<size; i++ )
+    	for ( j=0; j<size; j++ )
+    		cells[i*size + j] = (char) prand_cell(seed, i, j);
+
+    // Build the hash-consed quadtree from the flat board
+    root = build_tree(cells, size, level, 0, 0);
+    free(cells);
+
+    printf("Done!\n");
+    printf("\nProcessing generations... ");
+
+    // Print out the matrix
+    if ( PRINT_OUT )
+    {
+    	printf("\n\nGrid %dx%d:\n\n", size, size);
+    	print_tree(root, size);
+    	printf("\n");
+    }
+
+    // Process all generations by binary decomposition over memoized steps
+    root = advance(root, generations);
+
+    printf("Done!\n");
+    printf("\n-> Alive cells at the generation #%lld: %lld\n\n", generations, root->pop);
+
+    // Timestamp when serial part ends
+ 	end_serial = GetTime();
+
+ 	double time_serial = end_serial - begin_serial;
+ 	// Show statistics about execution time
+ 	printf("____________________________________________________\n\n");
+ 	printf("Execution time (by part):\n\n");
+ 	printf("- Serial:\t%.3f seconds\n", (double) time_serial);
+ 	printf("- Total:\t%.3f seconds\n", (double) time_serial);
+
+	// End of the program
+	return EXIT_SUCCESS;
+}
+
+
+// Function that hashes four child pointers into a bucket index
+static unsigned long long hash_children(Node *nw, Node *ne, Node *sw, Node *se)
+{
+	unsigned long long h = (unsigned long long) (uintptr_t) nw;
+
+	h = h * 0x9E3779B97F4A7C15ULL + (unsigned long long) (uintptr_t) ne;
+	h = h * 0x9E3779B97F4A7C15ULL + (unsigned long long) (uintptr_t) sw;
+	h = h * 0x9E3779B97F4A7C15ULL + (unsigned long long) (uintptr_t) se;
+
+	return (h >> 17) & (HASH_BUCKETS - 1);
+}
+
+// Function that returns the canonical node with the given children,
+// creating it if it has never been seen (hash-consing)
+Node *find_node(Node *nw, Node *ne, Node *sw, Node *se)
+{
+	unsigned long long	bucket = hash_children(nw, ne, sw, se);
+	Node				*n;
+
+	// Identical regions share one node
+	for ( n = hash_table[bucket]; n != NULL; n = n->hash_next )
+		if ( n->nw == nw && n->ne == ne && n->sw == sw && n->se == se )
+			return n;
+
+	n = (Node*) calloc(1, sizeof(Node));
+	n->nw = nw;
+	n->ne = ne;
+	n->sw = sw;
+	n->se = se;
+	n->level = nw->level + 1;
+	n->pop = nw->pop + ne->pop + sw->pop + se->pop;
+	n->partial_j = NO_PARTIAL;
+	n->hash_next = hash_table[bucket];
+	hash_table[bucket] = n;
+
+	return n;
+}
+
+// Function that returns the canonical all-dead node of a level
+Node *empty_node(int level)
+{
+	static Node	*cache[64];
+
+	if ( level == 0 )
+		return leaf_dead;
+
+	if ( level < 64 && cache[level] != NULL )
+		return cache[level];
+
+	Node *e = empty_node(level-1);
+	Node *n = find_node(e, e, e, e);
+
+	if ( level < 64 )
+		cache[level] = n;
+
+	return n;
+}
+
+// Function that re-centers a node one level up, surrounded by dead cells
+Node *expand(Node *n)
+{
+	Node	*e = empty_node(n->level - 1);
+
+	return find_node(find_node(e, e, e, n->nw),
+					 find_node(e, e, n->ne, e),
+					 find_node(e, n->sw, e, e),
+					 find_node(n->se, e, e, e));
+}
+
+// Function that tells whether the whole population sits in the center half,
+// so advancing the node cannot lose cells over the edge
+int is_padded(Node *n)
+{
+	return n->level >= 3
+		&& n->nw->pop == n->nw->se->se->pop
+		&& n->ne->pop == n->ne->sw->sw->pop
+		&& n->sw->pop == n->sw->ne->ne->pop
+		&& n->se->pop == n->se->nw->nw->pop;
+}
+
+// Function that reads one cell of a small node (row i, column j from its top-left)
+int get_cell(Node *n, long long i, long long j)
+{
+	long long	half;
+
+	if ( n->level == 0 )
+		return (int) n->pop;
+
+	half = 1LL << (n->level - 1);
+
+	if ( i < half )
+		return ( j < half ) ? get_cell(n->nw, i, j) : get_cell(n->ne, i, j-half);
+	else
+		return ( j < half ) ? get_cell(n->sw, i-half, j) : get_cell(n->se, i-half, j-half);
+}
+
+// Function that advances a level-2 node (4x4 cells) one generation,
+// returning its 2x2 center
+Node *life4x4(Node *n)
+{
+	int	b[4][4],
+		i,
+		j,
+		out[2][2];
+
+	for ( i=0; i<4; i++ )
+		for ( j=0; j<4; j++ )
+			b[i][j] = get_cell(n, i, j);
+
+	// Apply the rules to the four center cells
+	for ( i=1; i<=2; i++ )
+		for ( j=1; j<=2; j++ )
+		{
+			int alive_neighbors =
+				b[i-1][j-1] + b[i-1][j] + b[i-1][j+1] +
+				b[i][j-1] + b[i][j+1] +
+				b[i+1][j-1] + b[i+1][j] + b[i+1][j+1];
+
+			if ( alive_neighbors == 3 || ( alive_neighbors == 2 && b[i][j] == ALIVE ) )
+				out[i-1][j-1] = ALIVE;
+			else
+				out[i-1][j-1] = DEAD;
+		}
+
+	return find_node(out[0][0] ? leaf_alive : leaf_dead,
+					 out[0][1] ? leaf_alive : leaf_dead,
+					 out[1][0] ? leaf_alive : leaf_dead,
+					 out[1][1] ? leaf_alive : leaf_dead);
+}
+
+// Function that builds the level-(l-1) node of two horizontal neighbors' center
+static Node *horizontal(Node *w, Node *e)
+{
+	return find_node(w->ne, e->nw, w->se, e->sw);
+}
+
+// Function that builds the level-(l-1) node of two vertical neighbors' center
+static Node *vertical(Node *n, Node *s)
+{
+	return find_node(n->sw, n->se, s->nw, s->ne);
+}
+
+// Function that builds the centered level-(l-1) node of a node
+static Node *centered(Node *n)
+{
+	return find_node(n->nw->se, n->ne->sw, n->sw->ne, n->se->nw);
+}
+
+// Function that returns the center of a node advanced 2^(level-2)
+// generations, memoized per macrocell (this is HashLife's superspeed)
+Node *result(Node *n)
+{
+	if ( n->result != NULL )
+		return n->result;
+
+	if ( n->level == 2 )
+		n->result = life4x4(n);
+	else
+	{
+		// Nine overlapping half-size sub-squares, each advanced a half step...
+		Node	*n00 = result(n->nw),
+				*n01 = result(horizontal(n->nw, n->ne)),
+				*n02 = result(n->ne),
+				*n10 = result(vertical(n->nw, n->sw)),
+				*n11 = result(centered(n)),
+				*n12 = result(vertical(n->ne, n->se)),
+				*n20 = result(n->sw),
+				*n21 = result(horizontal(n->sw, n->se)),
+				*n22 = result(n->se);
+
+		// ...then four overlapping quads advanced the second half step
+		n->result = find_node(result(find_node(n00, n01, n10, n11)),
+							  result(find_node(n01, n02, n11, n12)),
+							  result(find_node(n10, n11, n20, n21)),
+							  result(find_node(n11, n12, n21, n22)));
+	}
+
+	return n->result;
+}
+
+// Function that returns the center of a node advanced 2^j generations
+// (j <= level-2); used to run generation counts that are not one huge power
+Node *successor(Node *n, int j)
+{
+	if ( n->pop == 0 )
+		return empty_node(n->level - 1);
+
+	if ( n->level == 2 || j >= n->level - 2 )
+		return result(n);
+
+	if ( n->partial_j == j )
+		return n->partial;
+
+	// Nine overlapping sub-squares advanced 2^j generations...
+	Node	*n00 = successor(n->nw, j),
+			*n01 = successor(horizontal(n->nw, n->ne), j),
+			*n02 = successor(n->ne, j),
+			*n10 = successor(vertical(n->nw, n->sw), j),
+			*n11 = successor(centered(n), j),
+			*n12 = successor(vertical(n->ne, n->se), j),
+			*n20 = successor(n->sw, j),
+			*n21 = successor(horizontal(n->sw, n->se), j),
+			*n22 = successor(n->se, j);
+
+	// ...then reassembled without a second advance (centers only)
+	n->partial = find_node(centered(find_node(n00, n01, n10, n11)),
+						   centered(find_node(n01, n02, n11, n12)),
+						   centered(find_node(n10, n11, n20, n21)),
+						   centered(find_node(n11, n12, n21, n22)));
+	n->partial_j = j;
+
+	return n->partial;
+}
+
+// Function that builds the canonical quadtree for a board region; cells
+// outside the board are dead
+Node *build_tree(char *cells, long long size, int level, long long top, long long left)
+{
+	if ( level == 0 )
+	{
+		if ( top >= 0 && top < size && left >= 0 && left < size && cells[top*size + left] )
+			return leaf_alive;
+
+		return leaf_dead;
+	}
+
+	long long half = 1LL << (level - 1);
+
+	return find_node(build_tree(cells, size, level-1, top, left),
+					 build_tree(cells, size, level-1, top, left+half),
+					 build_tree(cells, size, level-1, top+half, left),
+					 build_tree(cells, size, level-1, top+half, left+half));
+}
+
+// Function that advances the root by an arbitrary number of generations,
+// one power of two per memoized superspeed step
+Node *advance(Node *root, long long generations)
+{
+	int	j;
+
+	for ( j=62; j>=0; j-- )
+	{
+		if ( !(generations & (1LL << j)) )
+			continue;
+
+		// Pad the universe until the step cannot push cells over the edge
+		while ( root->level < j+2 || root->level < 3 || !is_padded(root) )
+			root = expand(root);
+
+		// One extra ring so the advanced center still holds everything
+		root = successor(expand(root), j);
+	}
+
+	return root;
+}
+
+// Function that print out the original board frame of the tree
+void print_tree(Node *n, long long s)
+{
+	long long	i,
+				j;
+
+	for ( i=0; i<s; i++ )
+    {
+    	for ( j=0; j<s; j++ )
+    		if ( get_cell(n, i, j) == ALIVE )
+    			printf(ALIVE_CHAR);
+    		else
+    			printf(DEAD_CHAR);
+
+    	printf("\n");
+    }
+}
+
+// Function that gets the current timestamp (monotonic wall clock; the old
+// clock()-based version summed CPU time across threads and made the parallel
+// numbers meaningless)
+double GetTime()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1000000000.0;
+}
@@ -11,9 +11,21 @@
  *  3.  The bigger the grid, the bigger the space required in memory.
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "rle.h"
+#include "checkpoint.h"
+#include "render.h"
+#include "prand.h"
+#include "hugealloc.h"
+#include "verify.h"
 #include <omp.h>
 
 // Maximum number of threads allowed (>0)
@@ -28,36 +40,55 @@
 #define ALIVE_CHAR	"▉"
 #define DEAD_CHAR	" "
 
-// Datatype for passing arguments
-typedef struct Args
+// Tile height: rows handed to a thread per chunk shrink toward this under
+// the guided schedule, so late chunks can fill scheduling gaps
+#define MIN_ROW_BLOCK 4
+
+// Tile width in cells: three source rows plus the output row of one tile
+// stay resident in L2 while the tile is processed
+#define COL_BLOCK 2048
+
+// Rows per strip in temporal-blocking mode (--tblock); a strip plus its
+// 2k halo rows must fit in cache for the k local steps to pay off
+#define TBLOCK_STRIP 64
+
+// Wall-clock seconds each thread spent computing its slices
+double thread_busy[MAX_THREADS] = {0};
+
+// Whether to pin each thread to one core, round robin (--pin)
+int pin_threads = 0;
+
+// Context for streaming RLE pattern cells into the padded grid
+typedef struct RleGrid
 {
-    int 		**from;
-    int 		**to;
-    int 		t_number;
+    int 		*m;
     long long	size;
-    long long	start;
-    int 		threads;
-} Args;
+} RleGrid;
+
+// Function that writes one alive pattern cell into the grid (clipped to it)
+static void rle_set_cell(void *ctx, long long row, long long col)
+{
+	RleGrid	*g = (RleGrid*) ctx;
 
-// Global variable
-int alert_extra_work = 0;
+	if ( row < g->size && col < g->size )
+		g->m[(row+1)*(g->size+2) + (col+1)] = ALIVE;
+}
 
 // Functions prototypes
-int 		**new_matrix(long long s);
-void		delete_matrix(int **m, long long s);
-int 		random_number();
-int 		read_neighbor(int **m, long long s, long long i, long long j);
-void 		process_generation(Args *arg);
-void 		print_matrix(int **m, long long s);
-long long	cells_alive(int **m, long long size);
+int 		*new_matrix(long long s);
+void		delete_matrix(int *m);
+void 		pin_worker_threads();
+void 		fill_ghost_cells(int *m, long long s);
+long long	process_generation(int *from, int *to, long long s);
+long long	process_generations_blocked(int *from, int *to, long long s, int k);
+void 		print_matrix(int *m, long long s);
+void 		print_timing_histogram(double *times, int n);
 double 		GetTime();
 
 // Main funtion
 int main(int argc, char* argv[])
 {
-	srand((unsigned int)time(NULL)); // Random number seeder
-
-	char* usage_msg = "Usage: ./game_pthread size generations threads\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tthreads - number of threads (> 0)\n\n";
+	char* usage_msg = "Usage: ./game_omp size generations threads [seed] [pattern.rle] [--checkpoint interval file] [--restore file] [--pin] [--tblock k] [--stats n] [--verify]\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tthreads - number of threads (> 0)\n\tseed - random seed for reproducible boards (optional)\n\tpattern - RLE pattern file to load instead of a random board (optional)\n\t--checkpoint - snapshot the board to file every interval generations\n\t--restore - resume from a snapshot file instead of generation 0\n\t--pin - pin each thread to one core (NUMA first-touch stays local)\n\t--tblock - advance k generations per pass over cache-sized row strips\n\t--stats - print one STATS line (generation, seconds, cells/s, GB/s, per-thread busy) every n generations\n\t--verify - print one VERIFY line (generation, population, board hash) per generation\n\n";
 
 	// Check the arguments
 	if ( argc < 4 )
@@ -80,15 +111,68 @@ int main(int argc, char* argv[])
 		return EXIT_FAILURE;
 	}
 
+	// Seed the random number generator (a fixed seed gives reproducible boards)
+	unsigned int seed = (unsigned int) time(NULL);
+
+	// Optional arguments: seed and pattern are positional, the snapshot
+	// options are flags so they can be combined with either
+	char		*pattern_file = NULL,
+				*checkpoint_file = NULL,
+				*restore_file = NULL;
+	int			checkpoint_interval = 0,
+				tblock = 0,
+				stats_interval = 0,
+				verify_mode = 0,
+				positionals = 0,
+				a;
+
+	for ( a=4; a<argc; a++ )
+	{
+		if ( strcmp(argv[a], "--checkpoint") == 0 && a+2 < argc )
+		{
+			checkpoint_interval = atoi(argv[a+1]);
+			checkpoint_file = argv[a+2];
+			a += 2;
+		}
+		else if ( strcmp(argv[a], "--restore") == 0 && a+1 < argc )
+			restore_file = argv[++a];
+		else if ( strcmp(argv[a], "--tblock") == 0 && a+1 < argc )
+			tblock = atoi(argv[++a]);
+		else if ( strcmp(argv[a], "--stats") == 0 && a+1 < argc )
+			stats_interval = atoi(argv[++a]);
+		else if ( strcmp(argv[a], "--verify") == 0 )
+			verify_mode = 1;
+		else if ( strcmp(argv[a], "--pin") == 0 )
+			pin_threads = 1;
+		else if ( positionals == 0 )
+		{
+			seed = (unsigned int) atoi(argv[a]);
+			positionals++;
+		}
+		else
+		{
+			pattern_file = argv[a];
+			positionals++;
+		}
+	}
+
 	// Program variables
-	int			**matrix = NULL,
-				**next_gen = NULL;
+	int			*matrix = NULL,
+				*next_gen = NULL,
+				*swap = NULL;
 	long long	i,
-				j;
+				j,
+				start_gen = 0,
+				alive_count = 0;
 	double		begin_serial,
  				end_serial,
  				begin_parallel,
- 				end_parallel;
+ 				end_parallel,
+ 				gen_start,
+ 				*gen_times = NULL;
+	long long	stats_last_gen = 0;
+	double		stats_last_time = 0.0,
+				stats_last_busy[MAX_THREADS] = {0};
 
  	// Timestamp when serial part starts
  	begin_serial = GetTime();
@@ -113,23 +197,68 @@ int main(int argc, char* argv[])
 
 	printf("\n> Using %d thread(s) to calculate...\n", thread_count);
 
+	// Pin the threads before any memory is touched, so the first-touch
+	// pages land on the socket that will keep using them
+	if ( pin_threads )
+	{
+		pin_worker_threads();
+
+		printf("\n> Threads pinned to cores (round robin).\n");
+	}
+
 	printf("\nGenerating matrix %lldx%lld... ", size, size);
 
-	// Create the matrix in the memory
+	// Create both matrices in the memory (reused for the whole run)
 	matrix = new_matrix(size);
+	next_gen = new_matrix(size);
 
 	printf("Done!\n\n");
 
 	printf("Filling out the matrix... ");
 
-    // Randomly fill the matrix
-    for ( i=0; i<size; i++ )
-    	for ( j=0; j<size; j++ )
-    		matrix[i][j] = random_number();
+    if ( restore_file != NULL )
+    {
+    	// Resume from a snapshot instead of generation 0
+    	if ( checkpoint_restore(restore_file, matrix, size, &start_gen, &alive_count) != 0 )
+    	{
+    		printf("Unable to restore the snapshot %s!\n\n", restore_file);
+
+    		return EXIT_FAILURE;
+    	}
+    }
+    else if ( pattern_file != NULL )
+    {
+    	// Decode the RLE pattern straight into the grid (background stays dead)
+    	RleGrid		ctx = { matrix, size };
+    	long long	pat_w = 0,
+    				pat_h = 0;
+
+    	if ( rle_load(pattern_file, &pat_w, &pat_h, rle_set_cell, &ctx) != 0 )
+    	{
+    		printf("Unable to load the pattern %s!\n\n", pattern_file);
+
+    		return EXIT_FAILURE;
+    	}
+
+    	if ( pat_w > size || pat_h > size )
+    		printf("\n[!] Pattern (%lldx%lld) is larger than the board and was clipped.\n", pat_w, pat_h);
+    }
+    else
+    {
+	    // Fill the matrix from the counter-based PRNG (pure hash of
+	    // seed and cell index), every thread filling its own rows
+	    #pragma omp parallel for schedule(static) private(j)
+	    for ( i=0; i<size; i++ )
+	    	for ( j=0; j<size; j++ )
+	    		matrix[(i+1)*(size+2) + (j+1)] = prand_cell(seed, i, j);
+	}
 
     printf("Done!\n");
     printf("\nProcessing generations... ");
 
+    // One timing slot per generation for the exit histogram
+    gen_times = (double*) malloc(generations * sizeof(double));
+
     // Print out the matrix
     if ( PRINT_OUT )
     {
@@ -143,56 +272,115 @@ int main(int argc, char* argv[])
  	// Timestamp when parallel part starts
  	begin_parallel = GetTime();
 
- 	// Thread variables
- 	int 	t_number;
-	Args 	*arg;
+ 	// The stats window starts where the run does
+ 	stats_last_gen = start_gen;
+ 	stats_last_time = GetTime();
+ 	for ( j=0; j<thread_count; j++ )
+ 		stats_last_busy[j] = thread_busy[j];
 
- 	// Process the generations
-    for ( i=0; i<generations; i++ )
+ 	// Process the generations (resuming past the restored ones, if any)
+    for ( i=start_gen; i<generations; )
     {
-    	// Create a new matrix
-	    next_gen = new_matrix(size);
-
-	    // Create the threads and run them
-		#pragma omp parallel private(t_number, arg)
-		{
-			t_number = omp_get_thread_num();
-			arg = malloc(sizeof(Args));
-
-			arg->from = matrix;
-			arg->to = next_gen;
-			arg->t_number = t_number;
-			arg->size = size;
-			arg->start = t_number;
-			arg->threads = thread_count;
-
-			process_generation(arg);
-		}
-
-    	// Copies next generation to current matrix
-	    delete_matrix(matrix, size);
+    	int	k_step = 1;
+
+    	gen_start = GetTime();
+
+    	// In temporal-blocking mode one pass advances up to tblock
+    	// generations; stop at the run end and at checkpoint boundaries
+    	// so the snapshots land on the exact generations
+    	if ( tblock > 1 )
+    	{
+    		k_step = tblock;
+
+    		if ( k_step > generations - i )
+    			k_step = (int) (generations - i);
+
+    		if ( checkpoint_interval > 0 && k_step > checkpoint_interval - (int) (i % checkpoint_interval) )
+    			k_step = checkpoint_interval - (int) (i % checkpoint_interval);
+    	}
+
+    	if ( k_step > 1 )
+    		// Advance k generations in one pass, the strips spread over the threads
+    		alive_count = process_generations_blocked(matrix, next_gen, size, k_step);
+    	else
+    	{
+		    // Copy the wrap rows/columns into the ghost border
+		    fill_ghost_cells(matrix, size);
+
+		    // Process the next generation (the population is counted as it is written)
+		    alive_count = process_generation(matrix, next_gen, size);
+    	}
+
+    	// Swap the matrices
+	    swap = matrix;
 	    matrix = next_gen;
-	    next_gen = NULL;
+	    next_gen = swap;
+
+    	// Spread the pass time over the generations it covered
+    	for ( j=0; j<k_step; j++ )
+    		gen_times[i+j] = (GetTime() - gen_start) / k_step;
+
+    	i += k_step;
+
+    	// One machine-readable throughput line per stats window: generation,
+    	// window seconds, cell updates per second, the effective bandwidth
+    	// those updates imply (one read and one write per cell), and each
+    	// thread's busy seconds in the window — stragglers show up directly
+    	if ( stats_interval > 0 && i - stats_last_gen >= stats_interval )
+    	{
+    		double		now = GetTime(),
+    					secs = now - stats_last_time;
+    		double		cps = ( secs > 0 ) ? (double) (i - stats_last_gen) * size * size / secs : 0;
+
+    		printf("STATS %lld %.6f %.3e %.3f", i, secs, cps, cps * 2.0 * sizeof(int) / 1e9);
+
+    		for ( j=0; j<thread_count; j++ )
+    		{
+    			printf(" %.6f", thread_busy[j] - stats_last_busy[j]);
+    			stats_last_busy[j] = thread_busy[j];
+    		}
+
+    		printf("\n");
+
+    		stats_last_gen = i;
+    		stats_last_time = now;
+    	}
+
+    	// One checksum line per generation for verify.sh; a blocked pass
+    	// only materializes its last generation, which the hash covers
+    	if ( verify_mode )
+    		printf("VERIFY %lld %lld %016llx\n", i, alive_count, verify_board_hash(matrix, size));
+
+    	// Periodically snapshot the board so the run can be resumed later;
+    	// the staged copy is written by the I/O thread while the next
+    	// generations compute
+    	if ( checkpoint_interval > 0 && i % checkpoint_interval == 0 )
+    		if ( checkpoint_async_write(checkpoint_file, matrix, size, i) != 0 )
+    			printf("\n[!] Unable to stage the snapshot %s at generation #%lld.\n", checkpoint_file, i);
 
     	// Print it out
     	if ( PRINT_OUT )
 	    {
-	    	printf("Generation #%d:\n\n", (int) i+1);
+	    	printf("Generation #%d (%lld alive):\n\n", (int) i, alive_count);
 	    	print_matrix(matrix, size);
 	    	printf("\n");
 	    }
     }
     
+    // Wait for the last snapshot to reach disk before reporting
+    checkpoint_async_finish();
+
     // Timestamp when parallel part ends
  	end_parallel = GetTime();
  	
  	/************** END PARALLEL *****************/
 
     printf("Done!\n");
-    printf("\n-> Alive cells at the generation #%d: %lld\n\n", generations, cells_alive(matrix, size));
+    printf("\n-> Alive cells at the generation #%d: %lld\n\n", generations, alive_count);
 
     // Delete the matrices from the memory
-    delete_matrix(matrix, size);
+    delete_matrix(matrix);
+    delete_matrix(next_gen);
 
     // Timestamp when serial part ends
  	end_serial = GetTime();
@@ -207,220 +395,352 @@ int main(int argc, char* argv[])
  	printf("- Parallel:\t%.3f seconds\n", (double) time_parallel);
  	printf("- Total:\t%.3f seconds\n", (double) time_serial);
 
+ 	// Busy time per thread exposes load imbalance between the row slices
+ 	printf("\nPer-thread busy time:\n\n");
+ 	for ( i=0; i<thread_count; i++ )
+ 		printf("- Thread #%d:\t%.3f seconds\n", (int) i+1, thread_busy[i]);
+
+ 	if ( generations > start_gen )
+ 	{
+ 		printf("\nPer-generation time histogram:\n\n");
+ 		print_timing_histogram(&gen_times[start_gen], (int) (generations - start_gen));
+ 	}
+ 	free(gen_times);
+
 	// End of the program
 	return EXIT_SUCCESS;
 }
 
 // Function that generate a matrix dinamycally
-int **new_matrix(long long s)
+int *new_matrix(long long s)
 {
-	// Create the matrix in the memory
-	long long	i;
-	int 		**m;
+	// Create the matrix in the memory as one contiguous block (row-major)
+	// with a one-cell ghost border on every side
+	int 		*m;
+	long long	i,
+				j,
+				p = s+2;
 
-	m = (int**) malloc(s * sizeof(int*));
-	
-	for ( i=0; i<s; i++ )
-        m[i] = (int*) malloc(s * sizeof(int));
+	m = (int*) huge_alloc(p * p * sizeof(int));
+
+	if ( m == NULL )
+		return m;
+
+	// First-touch initialization: each thread zeroes the rows it will mostly
+	// work on, so the pages are faulted in on that thread's own NUMA node
+	// instead of all landing on the node running main()
+	#pragma omp parallel for schedule(static) private(j)
+	for ( i=0; i<p; i++ )
+		for ( j=0; j<p; j++ )
+			m[i*p + j] = DEAD;
 
     return m;
 }
 
-// Function that removes a matrix from the memory
-void delete_matrix(int **m, long long s)
+// Function that pins each thread to one core, round robin, so the first-touch
+// pages stay local for the whole run (threads otherwise migrate between sockets)
+void pin_worker_threads()
 {
-	if ( m != NULL )
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if ( ncpus < 1 )
+		ncpus = 1;
+
+	#pragma omp parallel
 	{
-		int	i;
+		cpu_set_t set;
 
-		for ( i=0; i<s; i++ )
-		{
-			// Delete row in the matrix
-			free(m[i]);
-			m[i] = NULL;
-		}
+		CPU_ZERO(&set);
+		CPU_SET(omp_get_thread_num() % ncpus, &set);
 
-		// Delete the whole matrix
-		free(m);
-		m = NULL;
+		// Affects only the calling thread
+		sched_setaffinity(0, sizeof(set), &set);
 	}
 }
 
-// Function that generate and return a random number 0 or 1
-int random_number()
+// Function that removes a matrix from the memory
+void delete_matrix(int *m)
 {
-    if (rand() % 2 == 0)
-    	return ALIVE;
-    else
-    	return DEAD;
+	if ( m != NULL )
+	{
+		// Delete the whole matrix
+		huge_free(m);
+		m = NULL;
+	}
 }
 
-// Function that reads a neighbor
-int read_neighbor(int **m, long long s, long long i, long long j)
+
+// Function that copies the wrap rows/columns into the ghost border
+void fill_ghost_cells(int *m, long long s)
 {
-	if ( i < 0 )
-		i = s - 1;
-	else if ( i == s )
-		i = 0;
+	long long	k,
+				p = s+2;
 
-	if ( j < 0 )
-		j = s - 1;
-	else if ( j == s )
-		j = 0;
+	// Wrap rows: top ghost row mirrors the last row, bottom ghost row the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[0*p + k] = m[s*p + k];
+		m[(s+1)*p + k] = m[1*p + k];
+	}
+
+	// Wrap columns: left ghost column mirrors the last column, right the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[k*p + 0] = m[k*p + s];
+		m[k*p + (s+1)] = m[k*p + 1];
+	}
 
-	return m[i][j];
+	// Wrap the four corners
+	m[0*p + 0] = m[s*p + s];
+	m[0*p + (s+1)] = m[s*p + 1];
+	m[(s+1)*p + 0] = m[1*p + s];
+	m[(s+1)*p + (s+1)] = m[1*p + 1];
 }
 
-// Function that process the next generation
-void process_generation(Args *arg)
+// Function that process the next generation; the rows are handed to the
+// threads in guided blocks that shrink as the generation drains, so remainder
+// rows no longer pile up on thread 0; returns the number of alive cells in
+// the new generation, counted while it is written
+long long process_generation(int *from, int *to, long long s)
 {
-	long long	i,
-				j,
-				s = arg->size,
-				alive_neighbors = 0;
-	int			**from = arg->from,
-				**to = arg->to,
-				t_number = arg->t_number;
-
-	// If it has only one thread
-	if ( arg->threads == 1 )
+	long long	p = s+2,
+				alives = 0;
+
+	long long	col_blocks = (s + COL_BLOCK - 1) / COL_BLOCK,
+				row_blocks = (s + MIN_ROW_BLOCK - 1) / MIN_ROW_BLOCK;
+
+	#pragma omp parallel reduction(+: alives)
 	{
-		// Go through the matrix
-		for ( i=0; i<s; i++ )
+		long long	i,
+					j,
+					t,
+					alive_neighbors;
+		double		busy_start = GetTime();
+
+		// Go through the interior of the matrix (no wrap checks needed),
+		// one cache-sized tile per scheduled chunk
+		#pragma omp for schedule(guided) nowait
+		for ( t=0; t<row_blocks*col_blocks; t++ )
 		{
-			for ( j=0; j<s; j++ )
-			{
-				// Calculate the number of neighbors alive
-				alive_neighbors = 
-					read_neighbor(from, s, i-1,	j-1)	+ // Northwest
-	                read_neighbor(from, s, i-1,	j)		+ // North
-	                read_neighbor(from, s, i-1,	j+1)	+ // Northeast
-	                read_neighbor(from, s, i,	j-1)	+ // West
-	                read_neighbor(from, s, i,	j+1)	+ // East
-	                read_neighbor(from, s, i+1,	j-1)	+ // Southwest
-	                read_neighbor(from, s, i+1,	j)		+ // South
-	                read_neighbor(from, s, i+1,	j+1);	  // Southwest
-
-	            //printf("\n> Alive neighbors of [%lld][%lld]: %lld\n", i, j, alive_neighbors);
-
-	            // Apply the rules
+			long long	i0 = (t / col_blocks) * MIN_ROW_BLOCK + 1,
+						i1 = ( i0+MIN_ROW_BLOCK-1 <= s ) ? i0+MIN_ROW_BLOCK-1 : s,
+						j0 = (t % col_blocks) * COL_BLOCK + 1,
+						j1 = ( j0+COL_BLOCK-1 <= s ) ? j0+COL_BLOCK-1 : s;
+
+			for ( i=i0; i<=i1; i++ )
+				for ( j=j0; j<=j1; j++ )
+				{
+					// Calculate the number of neighbors alive
+					alive_neighbors = 
+						from[(i-1)*p + (j-1)]	+ // Northwest
+						from[(i-1)*p + j]		+ // North
+						from[(i-1)*p + (j+1)]	+ // Northeast
+						from[i*p + (j-1)]		+ // West
+						from[i*p + (j+1)]		+ // East
+						from[(i+1)*p + (j-1)]	+ // Southwest
+						from[(i+1)*p + j]		+ // South
+						from[(i+1)*p + (j+1)];	  // Southeast
+
+		            // Apply the rules
 	            
-	            if ( from[i][j] == ALIVE )
-	            {
-	                if ( alive_neighbors == 2 || alive_neighbors == 3 )
-	                    to[i][j] = ALIVE;
-	                else
-	                    to[i][j] = DEAD;
-	            }
-	            else
-	            {
-	                if ( alive_neighbors == 3 )
-	                    to[i][j] = ALIVE;
-	                else
-	                    to[i][j] = DEAD;
-	            }
+		            if ( from[i*p + j] == ALIVE )
+		            {
+		                if ( alive_neighbors == 2 || alive_neighbors == 3 )
+		                    to[i*p + j] = ALIVE;
+		                else
+		                    to[i*p + j] = DEAD;
+		            }
+		            else
+		            {
+		                if ( alive_neighbors == 3 )
+		                    to[i*p + j] = ALIVE;
+		                else
+		                    to[i*p + j] = DEAD;
+		            }
+
+		            // Accumulate this thread's share of the population
+		            alives += to[i*p + j];
+				}
 			}
-		}
+
+		// Account this thread's busy time
+		thread_busy[omp_get_thread_num()] += GetTime() - busy_start;
 	}
-	// More than one thread
-	else
+
+	return alives;
+}
+
+// Function that process one scratch row (columns 1..s) during a
+// temporal-blocking sub-step
+static void tblock_row(int *up, int *mid, int *down, int *out, long long s)
+{
+	long long	j;
+
+	for ( j=1; j<=s; j++ )
+	{
+		int	alive_neighbors =
+				up[j-1] + up[j] + up[j+1] +
+				mid[j-1] + mid[j+1] +
+				down[j-1] + down[j] + down[j+1];
+
+		if ( alive_neighbors == 3 || ( alive_neighbors == 2 && mid[j] == ALIVE ) )
+			out[j] = ALIVE;
+		else
+			out[j] = DEAD;
+	}
+}
+
+// Function that advance the whole board k generations in one pass using
+// overlapped row strips (see game.c); the strips only read the shared
+// 'from' board, so the threads process them independently with their own
+// scratch grids and no barrier until the pass ends
+long long process_generations_blocked(int *from, int *to, long long s, int k)
+{
+	long long	p = s+2,
+				max_rows = TBLOCK_STRIP + 2*k,
+				strips = (s + TBLOCK_STRIP - 1) / TBLOCK_STRIP,
+				alives = 0;
+
+	#pragma omp parallel reduction(+: alives)
 	{
-		// Calculate the thread's boundaries
- 		int rows = s / arg->threads;
- 		int start = rows * arg->start;
- 		int end = start + rows;
- 		int dif = s - ( arg->threads * rows );
- 		
- 		// If it is the first thread and the matrix size is odd
- 		if ( !alert_extra_work && t_number == 0 && s % 2 != 0 && dif > 0)
- 		{
- 			end += dif;
- 			alert_extra_work = 1;
-			
-			printf("\n\n[!] Thread #%d was elected to calculate %d extra line(s) (odd matrix size).\n\n", t_number+1, dif);
- 		}
-
- 		//printf("\n>> Hello from thread %d\n", t_number+1);
-		//printf("\tProcessing rows %d-%d\n", start+1, end);
-
- 		// Go through the matrix
- 		for ( i=start; i<end; i++ )
+		long long	b,
+					t,
+					j;
+		int			*sa = (int*) malloc(max_rows * p * sizeof(int)),
+					*sb = (int*) malloc(max_rows * p * sizeof(int)),
+					*sswap;
+		double		busy_start = GetTime();
+
+		#pragma omp for schedule(guided) nowait
+		for ( b=0; b<strips; b++ )
 		{
-			for ( j=0; j<s; j++ )
+			long long	r0 = b * TBLOCK_STRIP + 1,
+						strip_h = ( r0+TBLOCK_STRIP-1 <= s ) ? TBLOCK_STRIP : s-r0+1,
+						rows = strip_h + 2*k,
+						v0 = 0,
+						v1 = rows-1;
+			int			step;
+
+			// Copy the strip and its halo rows out of the current board,
+			// wrapping the row indices around the torus
+			for ( t=0; t<rows; t++ )
 			{
-				// Calculate the number of neighbors alive
-				alive_neighbors = 
-					read_neighbor(from, s, i-1,	j-1)	+ // Northwest
-	                read_neighbor(from, s, i-1,	j)		+ // North
-	                read_neighbor(from, s, i-1,	j+1)	+ // Northeast
-	                read_neighbor(from, s, i,	j-1)	+ // West
-	                read_neighbor(from, s, i,	j+1)	+ // East
-	                read_neighbor(from, s, i+1,	j-1)	+ // Southwest
-	                read_neighbor(from, s, i+1,	j)		+ // South
-	                read_neighbor(from, s, i+1,	j+1);	  // Southwest
-
-	            //printf("\n> Alive neighbors of [%lld][%lld]: %lld\n", i, j, alive_neighbors);
-
-	            // Apply the rules
-	            
-	            if ( from[i][j] == ALIVE )
-	            {
-	                if ( alive_neighbors == 2 || alive_neighbors == 3 )
-	                    to[i][j] = ALIVE;
-	                else
-	                    to[i][j] = DEAD;
-	            }
-	            else
-	            {
-	                if ( alive_neighbors == 3 )
-	                    to[i][j] = ALIVE;
-	                else
-	                    to[i][j] = DEAD;
-	            }
+				long long	src = ((r0 - k + t - 1) % s + s) % s + 1;
+
+				memcpy(&sa[t*p], &from[src*p], p * sizeof(int));
+			}
+
+			// Step the strip k times; every step consumes one halo row on
+			// each side, so after k steps the core rows are k generations on
+			for ( step=0; step<k; step++ )
+			{
+				// Wrap the columns of the still-valid rows
+				for ( t=v0; t<=v1; t++ )
+				{
+					sa[t*p + 0] = sa[t*p + s];
+					sa[t*p + (s+1)] = sa[t*p + 1];
+				}
+
+				for ( t=v0+1; t<=v1-1; t++ )
+					tblock_row(&sa[(t-1)*p], &sa[t*p], &sa[(t+1)*p], &sb[t*p], s);
+
+				v0++;
+				v1--;
+
+				sswap = sa;
+				sa = sb;
+				sb = sswap;
+			}
+
+			// Write the settled core back and count its population
+			for ( t=k; t<k+strip_h; t++ )
+			{
+				memcpy(&to[(r0 + t - k)*p + 1], &sa[t*p + 1], s * sizeof(int));
+
+				for ( j=1; j<=s; j++ )
+					alives += sa[t*p + j];
 			}
 		}
+
+		// Account this thread's busy time
+		thread_busy[omp_get_thread_num()] += GetTime() - busy_start;
+
+		free(sa);
+		free(sb);
 	}
 
-	// Delete unnecessary structure from the memory
-	free(arg);
-	arg = NULL;
+	return alives;
 }
 
-// Function that print out a matrix
-void print_matrix(int **m, long long s)
+// Function that print out a matrix (buffered; diffed against the previous
+// frame when stdout is a terminal)
+void print_matrix(int *m, long long s)
 {
-	long long	i,
-				j;
-
-	for ( i=0; i<s; i++ )
-    {
-    	for ( j=0; j<s; j++ )
-    		if ( m[i][j] == ALIVE )
-    			printf(ALIVE_CHAR);
-    		else
-    			printf(DEAD_CHAR);
-
-    	printf("\n");
-    }
+	render_frame(m, s, ALIVE_CHAR, DEAD_CHAR);
 }
 
-// Function that calculates the amount of alive cells in a grid
-long long cells_alive(int **m, long long s)
+// Function that prints a histogram of the per-generation times
+void print_timing_histogram(double *times, int n)
 {
-	long long	i,
-				j,
-				alives = 0;
+	double	min_t = times[0],
+			max_t = times[0],
+			width;
+	int		buckets[10] = {0},
+			i,
+			b,
+			biggest = 1;
+
+	for ( i=0; i<n; i++ )
+	{
+		if ( times[i] < min_t )
+			min_t = times[i];
+		if ( times[i] > max_t )
+			max_t = times[i];
+	}
 
-	for ( i=0; i<s; i++ )
-		for ( j=0; j<s; j++ )
-			if ( m[i][j] == ALIVE )
-				alives++;
+	width = (max_t - min_t) / 10.0;
 
-	return alives;
+	// Degenerate case: every generation took the same time
+	if ( width <= 0.0 )
+	{
+		printf("- %.6f s: %d generation(s)\n", min_t, n);
+
+		return;
+	}
+
+	for ( i=0; i<n; i++ )
+	{
+		b = (int) ((times[i] - min_t) / width);
+
+		if ( b > 9 )
+			b = 9;
+
+		buckets[b]++;
+	}
+
+	for ( b=0; b<10; b++ )
+		if ( buckets[b] > biggest )
+			biggest = buckets[b];
+
+	for ( b=0; b<10; b++ )
+	{
+		printf("- %.6f-%.6f s: %6d |", min_t + b*width, min_t + (b+1)*width, buckets[b]);
+
+		for ( i=0; i<(buckets[b]*40)/biggest; i++ )
+			printf("#");
+
+		printf("\n");
+	}
 }
 
-// Function that gets the current timestamp
+// Function that gets the current timestamp (monotonic wall clock; the old
+// clock()-based version summed CPU time across threads and made the parallel
+// numbers meaningless)
 double GetTime()
 {
-	return (double) clock() / CLOCKS_PER_SEC;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1000000000.0;
 }
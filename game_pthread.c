@@ -11,9 +11,20 @@
  *  3.  The bigger the grid, the bigger the space required in memory.
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "rle.h"
+#include "render.h"
+#include "prand.h"
+#include "hugealloc.h"
+#include "verify.h"
 #include <pthread.h>
 
 // Maximum number of threads allowed (>0)
@@ -28,36 +39,77 @@
 #define ALIVE_CHAR	"▉"
 #define DEAD_CHAR	" "
 
+// Tile height in rows: big enough to keep the shared counter cold,
+// small enough to balance the tail
+#define ROW_BLOCK 16
+
+// Tile width in cells: three source rows plus the output row of one tile
+// stay resident in L2 while the tile is processed
+#define COL_BLOCK 2048
+
 // Datatype for passing arguments
 typedef struct Args
 {
-    int 		**from;
-    int 		**to;
     int 		t_number;
     long long	size;
-    long long	start;
-    int 		threads;
+    long long	alives;
+    double		busy;
 } Args;
 
-// Global variable
-int alert_extra_work = 0;
+// Datatype for the first-touch workers
+typedef struct TouchArgs
+{
+    int 		t_number;
+    int 		threads;
+    long long	size;
+    int 		*m;
+} TouchArgs;
+
+// Whether to pin each thread to one core, round robin (--pin)
+int pin_threads = 0;
+
+// Shared state of the persistent worker pool: the main thread publishes the
+// grids for the next generation, then everybody meets on the barrier; the
+// workers pull row blocks from the shared queue counter until it drains, so
+// no thread is stuck with a fixed (or remainder-inflated) slice
+int					*shared_from = NULL,
+					*shared_to = NULL;
+long long			shared_next_tile = 0;
+int					shared_generations = 0;
+pthread_barrier_t	barrier;
+
+// Context for streaming RLE pattern cells into the padded grid
+typedef struct RleGrid
+{
+    int 		*m;
+    long long	size;
+} RleGrid;
+
+// Function that writes one alive pattern cell into the grid (clipped to it)
+static void rle_set_cell(void *ctx, long long row, long long col)
+{
+	RleGrid	*g = (RleGrid*) ctx;
+
+	if ( row < g->size && col < g->size )
+		g->m[(row+1)*(g->size+2) + (col+1)] = ALIVE;
+}
 
 // Functions prototypes
-int 		**new_matrix(long long s);
-void		delete_matrix(int **m, long long s);
-int 		random_number();
-int 		read_neighbor(int **m, long long s, long long i, long long j);
-void 		*process_generation(void *p);
-void 		print_matrix(int **m, long long s);
-long long	cells_alive(int **m, long long size);
+int 		*new_matrix(long long s);
+void		first_touch(int *m, long long s, int threads);
+void		*touch_matrix(void *thread_arg);
+void		pin_thread(int t_number);
+void		delete_matrix(int *m);
+void 		fill_ghost_cells(int *m, long long s);
+void 		*process_generation(void *thread_arg);
+void 		print_matrix(int *m, long long s);
+void 		print_timing_histogram(double *times, int n);
 double 		GetTime();
 
 // Main funtion
 int main(int argc, char* argv[])
 {
-	srand((unsigned int)time(NULL)); // Random number seeder
-
-	char* usage_msg = "Usage: ./game_pthread size generations threads\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tthreads - number of threads (> 0)\n\n";
+	char* usage_msg = "Usage: ./game_pthread size generations threads [seed] [pattern.rle] [--pin] [--stats n] [--verify]\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tthreads - number of threads (> 0)\n\tseed - random seed for reproducible boards (optional)\n\tpattern - RLE pattern file to load instead of a random board (optional)\n\t--pin - pin each thread to one core (NUMA first-touch stays local)\n\t--stats - print one STATS line (generation, seconds, cells/s, GB/s, per-thread busy) every n generations\n\t--verify - print one VERIFY line (generation, population, board hash) per generation\n\n";
 
 	// Check the arguments
 	if ( argc < 4 )
@@ -80,16 +132,55 @@ int main(int argc, char* argv[])
 		return EXIT_FAILURE;
 	}
 
+	// Seed the random number generator (a fixed seed gives reproducible boards)
+	unsigned int seed = (unsigned int) time(NULL);
+
+	// Optional arguments: seed and pattern are positional, the rest
+	// are flags
+	char	*pattern_file = NULL;
+	int		stats_interval = 0,
+			verify_mode = 0,
+			positionals = 0,
+			a;
+
+	for ( a=4; a<argc; a++ )
+	{
+		if ( strcmp(argv[a], "--pin") == 0 )
+			pin_threads = 1;
+		else if ( strcmp(argv[a], "--stats") == 0 && a+1 < argc )
+			stats_interval = atoi(argv[++a]);
+		else if ( strcmp(argv[a], "--verify") == 0 )
+			verify_mode = 1;
+		else if ( positionals == 0 )
+		{
+			seed = (unsigned int) atoi(argv[a]);
+			positionals++;
+		}
+		else
+		{
+			pattern_file = argv[a];
+			positionals++;
+		}
+	}
+
 	// Program variables
-	int			**matrix = NULL,
-				**next_gen = NULL;
+	int			*matrix = NULL,
+				*next_gen = NULL,
+				*swap = NULL;
 	long long	i,
-				j;
+				j,
+				alive_count = 0;
 	double		begin_serial,
  				end_serial,
  				begin_parallel,
- 				end_parallel;
+ 				end_parallel,
+ 				gen_start,
+ 				*gen_times = NULL;
  	pthread_t* 	thread_handles;
+ 	Args* 		args = NULL;
+	long long	stats_last_gen = 0;
+	double		stats_last_time = 0.0,
+				stats_last_busy[MAX_THREADS] = {0};
 
  	// Timestamp when serial part starts
  	begin_serial = GetTime();
@@ -116,21 +207,50 @@ int main(int argc, char* argv[])
 
 	printf("\nGenerating matrix %lldx%lld... ", size, size);
 
-	// Create the matrix in the memory
+	// Create both matrices in the memory (reused for the whole run); the
+	// first-touch workers fault the pages in on the NUMA nodes of the
+	// threads that will compute on them
 	matrix = new_matrix(size);
+	first_touch(matrix, size, thread_count);
+	next_gen = new_matrix(size);
+	first_touch(next_gen, size, thread_count);
 
 	printf("Done!\n\n");
 
 	printf("Filling out the matrix... ");
 
-    // Randomly fill the matrix
-    for ( i=0; i<size; i++ )
-    	for ( j=0; j<size; j++ )
-    		matrix[i][j] = random_number();
+    if ( pattern_file != NULL )
+    {
+    	// Decode the RLE pattern straight into the grid (background stays dead)
+    	RleGrid		ctx = { matrix, size };
+    	long long	pat_w = 0,
+    				pat_h = 0;
+
+    	if ( rle_load(pattern_file, &pat_w, &pat_h, rle_set_cell, &ctx) != 0 )
+    	{
+    		printf("Unable to load the pattern %s!\n\n", pattern_file);
+
+    		return EXIT_FAILURE;
+    	}
+
+    	if ( pat_w > size || pat_h > size )
+    		printf("\n[!] Pattern (%lldx%lld) is larger than the board and was clipped.\n", pat_w, pat_h);
+    }
+    else
+    {
+	    // Fill the matrix from the counter-based PRNG (pure hash of
+	    // seed and cell index, no hidden state)
+	    for ( i=0; i<size; i++ )
+	    	for ( j=0; j<size; j++ )
+	    		matrix[(i+1)*(size+2) + (j+1)] = prand_cell(seed, i, j);
+	}
 
     printf("Done!\n");
     printf("\nProcessing generations... ");
 
+    // One timing slot per generation for the exit histogram
+    gen_times = (double*) malloc(generations * sizeof(double));
+
     // Print out the matrix
     if ( PRINT_OUT )
     {
@@ -144,54 +264,112 @@ int main(int argc, char* argv[])
  	// Timestamp when parallel part starts
  	begin_parallel = GetTime();
 
+ 	// The main thread waits on the barrier too, so count it in
+ 	pthread_barrier_init(&barrier, NULL, thread_count+1);
+
+ 	// Number of generations every worker will process
+ 	shared_generations = generations;
+
+ 	// Create the persistent workers once; they park on the barrier
+ 	// between generations instead of being created and joined each step
+ 	args = (Args*) malloc(thread_count * sizeof(Args));
+
+	for ( j=0; j<thread_count; j++ )
+	{
+	 	args[j].t_number = j;
+	 	args[j].size = size;
+	 	args[j].busy = 0.0;
+
+	 	pthread_create(&thread_handles[j], NULL, process_generation, (void*)&args[j]);
+	}
+
+ 	// The stats window starts where the run does
+ 	stats_last_time = GetTime();
+
  	// Process the generations
     for ( i=0; i<generations; i++ )
     {
-    	// Create a new matrix
-	    next_gen = new_matrix(size);
+    	gen_start = GetTime();
 
-	    // Create the threads and run them
-		for ( j=0; j<thread_count; j++ )
-		{
-		 	Args *arg = malloc(sizeof(Args));
-		 	arg->from = matrix;
-		 	arg->to = next_gen;
-		 	arg->t_number = j;
-		 	arg->size = size;
-		 	arg->start = j;
-		 	arg->threads = thread_count;
-
-		 	pthread_create(&thread_handles[j], NULL, process_generation, (void*)arg);
-		}
-			
-		// Join all threads (wait until all of them are finished)
+	    // Copy the wrap rows/columns into the ghost border
+	    fill_ghost_cells(matrix, size);
+
+	    // Publish the grids for this generation, refill the tile queue and
+	    // release the workers
+	    shared_from = matrix;
+	    shared_to = next_gen;
+	    shared_next_tile = 0;
+	    pthread_barrier_wait(&barrier);
+
+		// Wait until every worker finished its slice
+		pthread_barrier_wait(&barrier);
+
+		// Reduce the per-worker population partials
+		alive_count = 0;
 		for ( j=0; j<thread_count; j++ )
-			pthread_join(thread_handles[j], NULL);
+			alive_count += args[j].alives;
 
-    	// Copies next generation to current matrix
-	    delete_matrix(matrix, size);
+    	// Swap the matrices
+	    swap = matrix;
 	    matrix = next_gen;
-	    next_gen = NULL;
+	    next_gen = swap;
+
+    	gen_times[i] = GetTime() - gen_start;
+
+    	// One machine-readable throughput line per stats window: generation,
+    	// window seconds, cell updates per second, the effective bandwidth
+    	// those updates imply (one read and one write per cell), and each
+    	// worker's busy seconds in the window — stragglers show up directly
+    	if ( stats_interval > 0 && i+1 - stats_last_gen >= stats_interval )
+    	{
+    		double		now = GetTime(),
+    					secs = now - stats_last_time;
+    		double		cps = ( secs > 0 ) ? (double) (i+1 - stats_last_gen) * size * size / secs : 0;
+
+    		printf("STATS %lld %.6f %.3e %.3f", i+1, secs, cps, cps * 2.0 * sizeof(int) / 1e9);
+
+    		for ( j=0; j<thread_count; j++ )
+    		{
+    			printf(" %.6f", args[j].busy - stats_last_busy[j]);
+    			stats_last_busy[j] = args[j].busy;
+    		}
+
+    		printf("\n");
+
+    		stats_last_gen = i+1;
+    		stats_last_time = now;
+    	}
+
+    	// One checksum line per generation for verify.sh
+    	if ( verify_mode )
+    		printf("VERIFY %lld %lld %016llx\n", i+1, alive_count, verify_board_hash(matrix, size));
 
     	// Print it out
     	if ( PRINT_OUT )
 	    {
-	    	printf("Generation #%d:\n\n", (int) i+1);
+	    	printf("Generation #%d (%lld alive):\n\n", (int) i+1, alive_count);
 	    	print_matrix(matrix, size);
 	    	printf("\n");
 	    }
     }
     
+	// Join all threads (they exit after the last generation)
+	for ( j=0; j<thread_count; j++ )
+		pthread_join(thread_handles[j], NULL);
+
+	pthread_barrier_destroy(&barrier);
+
     // Timestamp when parallel part ends
  	end_parallel = GetTime();
  	
  	/************** END PARALLEL *****************/
 
     printf("Done!\n");
-    printf("\n-> Alive cells at the generation #%d: %lld\n\n", generations, cells_alive(matrix, size));
+    printf("\n-> Alive cells at the generation #%d: %lld\n\n", generations, alive_count);
 
     // Delete the matrices from the memory
-    delete_matrix(matrix, size);
+    delete_matrix(matrix);
+    delete_matrix(next_gen);
 
     // Timestamp when serial part ends
  	end_serial = GetTime();
@@ -206,224 +384,294 @@ int main(int argc, char* argv[])
  	printf("- Parallel:\t%.3f seconds\n", (double) time_parallel);
  	printf("- Total:\t%.3f seconds\n", (double) time_serial);
 
+ 	// Busy time per worker exposes load imbalance between the row slices
+ 	printf("\nPer-thread busy time:\n\n");
+ 	for ( j=0; j<thread_count; j++ )
+ 		printf("- Thread #%d:\t%.3f seconds\n", (int) j+1, args[j].busy);
+
+ 	printf("\nPer-generation time histogram:\n\n");
+ 	print_timing_histogram(gen_times, generations);
+ 	free(gen_times);
+ 	free(args);
+
 	// End of the program
 	return EXIT_SUCCESS;
 }
 
 // Function that generate a matrix dinamycally
-int **new_matrix(long long s)
+int *new_matrix(long long s)
 {
-	// Create the matrix in the memory
-	long long	i;
-	int 		**m;
+	// Create the matrix in the memory as one contiguous block (row-major)
+	// with a one-cell ghost border on every side; the pages are left
+	// untouched here so first_touch() decides where they fault in
+	int 		*m;
 
-	m = (int**) malloc(s * sizeof(int*));
-	
-	for ( i=0; i<s; i++ )
-        m[i] = (int*) malloc(s * sizeof(int));
+	m = (int*) huge_alloc((s+2) * (s+2) * sizeof(int));
 
     return m;
 }
 
-// Function that removes a matrix from the memory
-void delete_matrix(int **m, long long s)
+// Function that zeroes a fresh matrix with one short-lived thread per worker,
+// so each slice of pages faults in on the node of the core that touches it
+void first_touch(int *m, long long s, int threads)
 {
-	if ( m != NULL )
+	pthread_t	handles[MAX_THREADS];
+	TouchArgs	args[MAX_THREADS];
+	int			t;
+
+	for ( t=0; t<threads; t++ )
 	{
-		int	i;
+		args[t].t_number = t;
+		args[t].threads = threads;
+		args[t].size = s;
+		args[t].m = m;
 
-		for ( i=0; i<s; i++ )
-		{
-			// Delete row in the matrix
-			free(m[i]);
-			m[i] = NULL;
-		}
+		pthread_create(&handles[t], NULL, touch_matrix, (void*)&args[t]);
+	}
 
+	for ( t=0; t<threads; t++ )
+		pthread_join(handles[t], NULL);
+}
+
+// Function run by each first-touch worker: zeroes a static slice of the rows
+// from the core it is pinned to
+void *touch_matrix(void *thread_arg)
+{
+	TouchArgs	*arg = (TouchArgs*) thread_arg;
+	long long	p = arg->size+2,
+				rows = (p + arg->threads - 1) / arg->threads,
+				start = arg->t_number * rows,
+				end = start + rows,
+				i,
+				j;
+
+	if ( pin_threads )
+		pin_thread(arg->t_number);
+
+	if ( end > p )
+		end = p;
+
+	for ( i=start; i<end; i++ )
+		for ( j=0; j<p; j++ )
+			arg->m[i*p + j] = DEAD;
+
+	pthread_exit(NULL);
+}
+
+// Function that pins the calling thread to a core, round robin, so its
+// first-touch pages stay local for the whole run
+void pin_thread(int t_number)
+{
+	long		ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	cpu_set_t	set;
+
+	if ( ncpus < 1 )
+		ncpus = 1;
+
+	CPU_ZERO(&set);
+	CPU_SET(t_number % ncpus, &set);
+
+	// Affects only the calling thread
+	sched_setaffinity(0, sizeof(set), &set);
+}
+
+// Function that removes a matrix from the memory
+void delete_matrix(int *m)
+{
+	if ( m != NULL )
+	{
 		// Delete the whole matrix
-		free(m);
+		huge_free(m);
 		m = NULL;
 	}
 }
 
-// Function that generate and return a random number 0 or 1
-int random_number()
-{
-    if (rand() % 2 == 0)
-    	return ALIVE;
-    else
-    	return DEAD;
-}
 
-// Function that reads a neighbor
-int read_neighbor(int **m, long long s, long long i, long long j)
+// Function that copies the wrap rows/columns into the ghost border
+void fill_ghost_cells(int *m, long long s)
 {
-	if ( i < 0 )
-		i = s - 1;
-	else if ( i == s )
-		i = 0;
+	long long	k,
+				p = s+2;
+
+	// Wrap rows: top ghost row mirrors the last row, bottom ghost row the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[0*p + k] = m[s*p + k];
+		m[(s+1)*p + k] = m[1*p + k];
+	}
 
-	if ( j < 0 )
-		j = s - 1;
-	else if ( j == s )
-		j = 0;
+	// Wrap columns: left ghost column mirrors the last column, right the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[k*p + 0] = m[k*p + s];
+		m[k*p + (s+1)] = m[k*p + 1];
+	}
 
-	return m[i][j];
+	// Wrap the four corners
+	m[0*p + 0] = m[s*p + s];
+	m[0*p + (s+1)] = m[s*p + 1];
+	m[(s+1)*p + 0] = m[1*p + s];
+	m[(s+1)*p + (s+1)] = m[1*p + 1];
 }
 
-// Function that process the next generation
-void *process_generation(void *p)
+// Function run by each persistent worker: pulls row blocks from the shared
+// queue every generation, meeting the main thread on the barrier before and
+// after each one
+void *process_generation(void *thread_arg)
 {
-	Args 		*arg = (Args*) p;
+	Args 		*arg = (Args*) thread_arg;
 	long long	i,
 				j,
+				g,
+				t,
 				s = arg->size,
-				alive_neighbors = 0;
-	int			**from = arg->from,
-				**to = arg->to,
-				t_number = arg->t_number;
+				p = s+2,
+				alive_neighbors = 0,
+				col_blocks = (s + COL_BLOCK - 1) / COL_BLOCK,
+				tiles = ((s + ROW_BLOCK - 1) / ROW_BLOCK) * col_blocks;
 
-	// Delete unnecessary structure from the memory
-	free(p);
-	p = NULL;
+	// Pin this worker to the same core its first-touch twin used
+	if ( pin_threads )
+		pin_thread(arg->t_number);
 
-	// If it has only one thread
-	if ( arg->threads == 1 )
-	{
-		// Go through the matrix
-		for ( i=0; i<s; i++ )
-		{
-			for ( j=0; j<s; j++ )
-			{
-				// Calculate the number of neighbors alive
-				alive_neighbors = 
-					read_neighbor(from, s, i-1,	j-1)	+ // Northwest
-	                read_neighbor(from, s, i-1,	j)		+ // North
-	                read_neighbor(from, s, i-1,	j+1)	+ // Northeast
-	                read_neighbor(from, s, i,	j-1)	+ // West
-	                read_neighbor(from, s, i,	j+1)	+ // East
-	                read_neighbor(from, s, i+1,	j-1)	+ // Southwest
-	                read_neighbor(from, s, i+1,	j)		+ // South
-	                read_neighbor(from, s, i+1,	j+1);	  // Southwest
-
-	            //printf("\n> Alive neighbors of [%lld][%lld]: %lld\n", i, j, alive_neighbors);
-
-	            // Apply the rules
-	            
-	            if ( from[i][j] == ALIVE )
-	            {
-	                if ( alive_neighbors == 2 || alive_neighbors == 3 )
-	                    to[i][j] = ALIVE;
-	                else
-	                    to[i][j] = DEAD;
-	            }
-	            else
-	            {
-	                if ( alive_neighbors == 3 )
-	                    to[i][j] = ALIVE;
-	                else
-	                    to[i][j] = DEAD;
-	            }
-			}
-		}
-	}
-	// More than one thread
-	else
+	// Process every generation, parked on the barrier in between
+	for ( g=0; g<shared_generations; g++ )
 	{
-		// Calculate the thread's boundaries
- 		int rows = s / arg->threads;
- 		int start = rows * arg->start;
- 		int end = start + rows;
- 		int dif = s - ( arg->threads * rows );
- 		
- 		// If it is the first thread and the matrix size is odd
- 		if ( !alert_extra_work && t_number == 0 && s % 2 != 0 && dif > 0)
- 		{
- 			end += dif;
- 			alert_extra_work = 1;
-			
-			printf("\n\n[!] Thread #%d was elected to calculate %d extra line(s) (odd matrix size).\n\n", t_number+1, dif);
- 		}
-
- 		//printf("\n>> Hello from thread %d\n", t_number+1);
-		//printf("\tProcessing rows %d-%d\n", start+1, end);
-
- 		// Go through the matrix
- 		for ( i=start; i<end; i++ )
+		// Wait for the main thread to publish the grids
+		pthread_barrier_wait(&barrier);
+
+		int			*from = shared_from,
+					*to = shared_to;
+		long long	alives = 0;
+		double		busy_start = GetTime();
+
+		// Pull cache-sized tiles off the shared queue until the generation
+		// drains; whichever thread finishes a tile first grabs the next one
+		while ( (t = __sync_fetch_and_add(&shared_next_tile, 1)) < tiles )
 		{
-			for ( j=0; j<s; j++ )
+			long long	i0 = (t / col_blocks) * ROW_BLOCK + 1,
+						i1 = ( i0+ROW_BLOCK-1 <= s ) ? i0+ROW_BLOCK-1 : s,
+						j0 = (t % col_blocks) * COL_BLOCK + 1,
+						j1 = ( j0+COL_BLOCK-1 <= s ) ? j0+COL_BLOCK-1 : s;
+
+			// Go through the interior of this tile (no wrap checks needed)
+			for ( i=i0; i<=i1; i++ )
 			{
-				// Calculate the number of neighbors alive
-				alive_neighbors = 
-					read_neighbor(from, s, i-1,	j-1)	+ // Northwest
-	                read_neighbor(from, s, i-1,	j)		+ // North
-	                read_neighbor(from, s, i-1,	j+1)	+ // Northeast
-	                read_neighbor(from, s, i,	j-1)	+ // West
-	                read_neighbor(from, s, i,	j+1)	+ // East
-	                read_neighbor(from, s, i+1,	j-1)	+ // Southwest
-	                read_neighbor(from, s, i+1,	j)		+ // South
-	                read_neighbor(from, s, i+1,	j+1);	  // Southwest
-
-	            //printf("\n> Alive neighbors of [%lld][%lld]: %lld\n", i, j, alive_neighbors);
-
-	            // Apply the rules
-	            
-	            if ( from[i][j] == ALIVE )
-	            {
-	                if ( alive_neighbors == 2 || alive_neighbors == 3 )
-	                    to[i][j] = ALIVE;
-	                else
-	                    to[i][j] = DEAD;
-	            }
-	            else
-	            {
-	                if ( alive_neighbors == 3 )
-	                    to[i][j] = ALIVE;
-	                else
-	                    to[i][j] = DEAD;
-	            }
+				for ( j=j0; j<=j1; j++ )
+				{
+					// Calculate the number of neighbors alive
+					alive_neighbors = 
+						from[(i-1)*p + (j-1)]	+ // Northwest
+						from[(i-1)*p + j]		+ // North
+						from[(i-1)*p + (j+1)]	+ // Northeast
+						from[i*p + (j-1)]		+ // West
+						from[i*p + (j+1)]		+ // East
+						from[(i+1)*p + (j-1)]	+ // Southwest
+						from[(i+1)*p + j]		+ // South
+						from[(i+1)*p + (j+1)];	  // Southeast
+
+					// Apply the rules
+
+					if ( from[i*p + j] == ALIVE )
+					{
+						if ( alive_neighbors == 2 || alive_neighbors == 3 )
+							to[i*p + j] = ALIVE;
+						else
+							to[i*p + j] = DEAD;
+					}
+					else
+					{
+						if ( alive_neighbors == 3 )
+							to[i*p + j] = ALIVE;
+						else
+							to[i*p + j] = DEAD;
+					}
+
+					// Accumulate this worker's share of the population
+					alives += to[i*p + j];
+				}
 			}
 		}
+
+		// Publish the partial and busy time, then signal that this slice is done
+		arg->alives = alives;
+		arg->busy += GetTime() - busy_start;
+		pthread_barrier_wait(&barrier);
 	}
 
 	// Terminate the thread
 	pthread_exit(NULL);
 }
 
-// Function that print out a matrix
-void print_matrix(int **m, long long s)
+// Function that print out a matrix (buffered; diffed against the previous
+// frame when stdout is a terminal)
+void print_matrix(int *m, long long s)
 {
-	long long	i,
-				j;
-
-	for ( i=0; i<s; i++ )
-    {
-    	for ( j=0; j<s; j++ )
-    		if ( m[i][j] == ALIVE )
-    			printf(ALIVE_CHAR);
-    		else
-    			printf(DEAD_CHAR);
-
-    	printf("\n");
-    }
+	render_frame(m, s, ALIVE_CHAR, DEAD_CHAR);
 }
 
-// Function that calculates the amount of alive cells in a grid
-long long cells_alive(int **m, long long s)
+// Function that prints a histogram of the per-generation times
+void print_timing_histogram(double *times, int n)
 {
-	long long	i,
-				j,
-				alives = 0;
+	double	min_t = times[0],
+			max_t = times[0],
+			width;
+	int		buckets[10] = {0},
+			i,
+			b,
+			biggest = 1;
+
+	for ( i=0; i<n; i++ )
+	{
+		if ( times[i] < min_t )
+			min_t = times[i];
+		if ( times[i] > max_t )
+			max_t = times[i];
+	}
 
-	for ( i=0; i<s; i++ )
-		for ( j=0; j<s; j++ )
-			if ( m[i][j] == ALIVE )
-				alives++;
+	width = (max_t - min_t) / 10.0;
 
-	return alives;
+	// Degenerate case: every generation took the same time
+	if ( width <= 0.0 )
+	{
+		printf("- %.6f s: %d generation(s)\n", min_t, n);
+
+		return;
+	}
+
+	for ( i=0; i<n; i++ )
+	{
+		b = (int) ((times[i] - min_t) / width);
+
+		if ( b > 9 )
+			b = 9;
+
+		buckets[b]++;
+	}
+
+	for ( b=0; b<10; b++ )
+		if ( buckets[b] > biggest )
+			biggest = buckets[b];
+
+	for ( b=0; b<10; b++ )
+	{
+		printf("- %.6f-%.6f s: %6d |", min_t + b*width, min_t + (b+1)*width, buckets[b]);
+
+		for ( i=0; i<(buckets[b]*40)/biggest; i++ )
+			printf("#");
+
+		printf("\n");
+	}
 }
 
-// Function that gets the current timestamp
+// Function that gets the current timestamp (monotonic wall clock; the old
+// clock()-based version summed CPU time across threads and made the parallel
+// numbers meaningless)
 double GetTime()
 {
-	return (double) clock() / CLOCKS_PER_SEC;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1000000000.0;
 }
@@ -0,0 +1,421 @@
+/* File:    game_sparse.c
+ * Purpose: Run the Game of Life processing only the active region of the board.
+ * Compile: make -f make_game_sparse
+ * Run:     ./game_sparse <grid size> <number of generations> <number of threads>
+ * Input:   None
+ * Output:  Resultant generation, number of alive cells, and time spent doing calculations.
+ *
+ * Notes:
+ *  1.  Time given in seconds.
+ *  2.  The board is split into tiles; a generation only recomputes tiles that
+ *      changed last generation or sit next to one that did. Tiles that are
+ *      provably static are copied forward instead of recomputed.
+ *  3.  On mostly-dead boards (gliders, guns, small colonies) this skips the
+ *      vast majority of the per-generation work.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <omp.h>
+
+#include "render.h"
+#include "prand.h"
+#include "hugealloc.h"
+#include "verify.h"
+
+// Maximum number of threads allowed (>0)
+#define MAX_THREADS 200
+
+// Whether or not to print matrices (1/0)
+#define PRINT_OUT 0
+
+// Tile side length in cells
+#define TILE_SIZE 64
+
+// Cell definitions (must be integers and char*)
+#define ALIVE 		1
+#define DEAD		0
+#define ALIVE_CHAR	"▉"
+#define DEAD_CHAR	" "
+
+// Functions prototypes
+int 		*new_matrix(long long s);
+void		delete_matrix(int *m);
+void 		fill_ghost_cells(int *m, long long s);
+int 		process_tile(int *from, int *to, long long s, long long ty, long long tx);
+void 		copy_tile(int *from, int *to, long long s, long long ty, long long tx);
+void 		print_matrix(int *m, long long s);
+long long	cells_alive(int *m, long long size);
+double 		GetTime();
+
+// Main funtion
+int main(int argc, char* argv[])
+{
+	char* usage_msg = "Usage: ./game_sparse size generations threads [seed] [--verify]\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tthreads - number of threads (> 0)\n\tseed - random seed for reproducible boards (optional)\n\t--verify - print one VERIFY line (generation, population, board hash) per generation\n\n";
+
+	// Check the arguments
+	if ( argc < 4 )
+	{
+		printf(usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Get the arguments
+	long long	size = atoi(argv[1]);
+	int			generations = atoi(argv[2]),
+				thread_count = atoi(argv[3]);
+
+	// If no valid arguments were provided
+	if ( size == 0 || generations == 0 || thread_count == 0 )
+	{
+		printf(usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Seed the random number generator (a fixed seed gives reproducible boards)
+	unsigned int seed = (unsigned int) time(NULL);
+
+	// Optional arguments: seed is positional, --verify is a flag
+	int	verify_mode = 0,
+		a;
+
+	for ( a=4; a<argc; a++ )
+	{
+		if ( strcmp(argv[a], "--verify") == 0 )
+			verify_mode = 1;
+		else
+			seed = (unsigned int) atoi(argv[a]);
+	}
+
+	// Program variables
+	int			*matrix = NULL,
+				*next_gen = NULL,
+				*swap = NULL;
+	long long	i,
+				j,
+				t,
+				nt = (size + TILE_SIZE - 1) / TILE_SIZE;
+	char		*dirty = NULL,
+				*next_dirty = NULL,
+				*need = NULL,
+				*swap_dirty = NULL;
+	double		begin_serial,
+ 				end_serial,
+ 				begin_parallel,
+ 				end_parallel;
+
+ 	// Timestamp when serial part starts
+ 	begin_serial = GetTime();
+
+ 	// Calculate the correct number of threads
+	if ( thread_count > MAX_THREADS )
+	{
+	 	thread_count = MAX_THREADS;
+
+	 	printf("\n[!] Number of threads lowered to %d (maximum threads limit).\n", MAX_THREADS);
+	}
+
+	// Define the number of threads
+	omp_set_num_threads(thread_count);
+
+	printf("\n> Using %d thread(s) to calculate...\n", thread_count);
+
+	printf("\nGenerating matrix %lldx%lld (%lldx%lld tiles)... ", size, size, nt, nt);
+
+	// Create both matrices in the memory (reused for the whole run)
+	matrix = new_matrix(size);
+	next_gen = new_matrix(size);
+
+	// Create the tile dirty-flags; everything starts dirty
+	dirty = (char*) malloc(nt * nt * sizeof(char));
+	next_dirty = (char*) malloc(nt * nt * sizeof(char));
+	need = (char*) malloc(nt * nt * sizeof(char));
+	memset(dirty, 1, nt * nt);
+
+	printf("Done!\n\n");
+
+	printf("Filling out the matrix... ");
+
+    // Fill the matrix from the counter-based PRNG (pure hash of
+    // seed and cell index, no hidden state)
+    for ( i=0; i<size; i++ )
+    	for ( j=0; j<size; j++ )
+    		matrix[(i+1)*(size+2) + (j+1)] = prand_cell(seed, i, j);
+
+    printf("Done!\n");
+    printf("\nProcessing generations... ");
+
+    // Print out the matrix
+    if ( PRINT_OUT )
+    {
+    	printf("\n\nGrid %lldx%lld:\n\n", size, size);
+    	print_matrix(matrix, size);
+    	printf("\n");
+    }
+
+    /************* BEGIN PARALLEL ****************/
+
+ 	// Timestamp when parallel part starts
+ 	begin_parallel = GetTime();
+
+ 	// Process the generations
+    for ( i=0; i<generations; i++ )
+    {
+    	// A tile needs work if it, or any of its eight (torus-wrapped)
+    	// neighbor tiles, changed last generation
+    	for ( t=0; t<nt*nt; t++ )
+    	{
+    		long long	ty = t / nt,
+    					tx = t % nt,
+    					dy,
+    					dx;
+    		char		needed = 0;
+
+    		for ( dy=-1; dy<=1 && !needed; dy++ )
+    			for ( dx=-1; dx<=1; dx++ )
+    				if ( dirty[((ty+dy+nt) % nt)*nt + ((tx+dx+nt) % nt)] )
+    				{
+    					needed = 1;
+    					break;
+    				}
+
+    		need[t] = needed;
+    	}
+
+	    // Copy the wrap rows/columns into the ghost border
+	    fill_ghost_cells(matrix, size);
+
+	    // Process the needed tiles; static ones are just copied forward
+		#pragma omp parallel for schedule(dynamic)
+    	for ( t=0; t<nt*nt; t++ )
+    	{
+    		if ( need[t] )
+    			next_dirty[t] = process_tile(matrix, next_gen, size, t / nt, t % nt);
+    		else
+    		{
+    			copy_tile(matrix, next_gen, size, t / nt, t % nt);
+    			next_dirty[t] = 0;
+    		}
+    	}
+
+    	// Swap the matrices and the dirty-flags
+	    swap = matrix;
+	    matrix = next_gen;
+	    next_gen = swap;
+	    swap_dirty = dirty;
+	    dirty = next_dirty;
+	    next_dirty = swap_dirty;
+
+    	// One checksum line per generation for verify.sh
+    	if ( verify_mode )
+    		printf("VERIFY %lld %lld %016llx\n", i+1, cells_alive(matrix, size), verify_board_hash(matrix, size));
+
+    	// Print it out
+    	if ( PRINT_OUT )
+	    {
+	    	printf("Generation #%d:\n\n", (int) i+1);
+	    	print_matrix(matrix, size);
+	    	printf("\n");
+	    }
+    }
+
+    // Timestamp when parallel part ends
+ 	end_parallel = GetTime();
+
+ 	/************** END PARALLEL *****************/
+
+    printf("Done!\n");
+    printf("\n-> Alive cells at the generation #%d: %lld\n\n", generations, cells_alive(matrix, size));
+
+    // Delete the matrices from the memory
+    delete_matrix(matrix);
+    delete_matrix(next_gen);
+    free(dirty);
+    free(next_dirty);
+    free(need);
+
+    // Timestamp when serial part ends
+ 	end_serial = GetTime();
+
+ 	// Calculate each time spent
+ 	double time_parallel = end_parallel - begin_parallel;
+ 	double time_serial = end_serial - begin_serial;
+ 	// Show statistics about execution time
+ 	printf("____________________________________________________\n\n");
+ 	printf("Execution time (by part):\n\n");
+ 	printf("- Serial:\t%.3f seconds\n", (double) time_serial-time_parallel);
+ 	printf("- Parallel:\t%.3f seconds\n", (double) time_parallel);
+ 	printf("- Total:\t%.3f seconds\n", (double) time_serial);
+
+	// End of the program
+	return EXIT_SUCCESS;
+}
+
+// Function that generate a matrix dinamycally
+int *new_matrix(long long s)
+{
+	// Create the matrix in the memory as one contiguous block (row-major)
+	// with a one-cell ghost border on every side
+	int 		*m;
+
+	m = (int*) huge_alloc((s+2) * (s+2) * sizeof(int));
+
+    return m;
+}
+
+// Function that removes a matrix from the memory
+void delete_matrix(int *m)
+{
+	if ( m != NULL )
+	{
+		// Delete the whole matrix
+		huge_free(m);
+		m = NULL;
+	}
+}
+
+
+// Function that copies the wrap rows/columns into the ghost border
+void fill_ghost_cells(int *m, long long s)
+{
+	long long	k,
+				p = s+2;
+
+	// Wrap rows: top ghost row mirrors the last row, bottom ghost row the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[0*p + k] = m[s*p + k];
+		m[(s+1)*p + k] = m[1*p + k];
+	}
+
+	// Wrap columns: left ghost column mirrors the last column, right the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[k*p + 0] = m[k*p + s];
+		m[k*p + (s+1)] = m[k*p + 1];
+	}
+
+	// Wrap the four corners
+	m[0*p + 0] = m[s*p + s];
+	m[0*p + (s+1)] = m[s*p + 1];
+	m[(s+1)*p + 0] = m[1*p + s];
+	m[(s+1)*p + (s+1)] = m[1*p + 1];
+}
+
+// Function that process one tile of the next generation; returns 1 if any
+// cell in the tile changed
+int process_tile(int *from, int *to, long long s, long long ty, long long tx)
+{
+	long long	p = s+2,
+				i0 = ty*TILE_SIZE + 1,
+				j0 = tx*TILE_SIZE + 1,
+				i1 = i0 + TILE_SIZE - 1,
+				j1 = j0 + TILE_SIZE - 1,
+				i,
+				j,
+				alive_neighbors;
+	int			changed = 0;
+
+	// Clamp the last tile row/column to the board
+	if ( i1 > s )
+		i1 = s;
+	if ( j1 > s )
+		j1 = s;
+
+	// Go through the interior of the tile (no wrap checks needed)
+	for ( i=i0; i<=i1; i++ )
+		for ( j=j0; j<=j1; j++ )
+		{
+			// Calculate the number of neighbors alive
+			alive_neighbors =
+				from[(i-1)*p + (j-1)]	+ // Northwest
+                from[(i-1)*p + j]		+ // North
+                from[(i-1)*p + (j+1)]	+ // Northeast
+                from[i*p + (j-1)]		+ // West
+                from[i*p + (j+1)]		+ // East
+                from[(i+1)*p + (j-1)]	+ // Southwest
+                from[(i+1)*p + j]		+ // South
+                from[(i+1)*p + (j+1)];	  // Southeast
+
+            // Apply the rules
+
+            if ( from[i*p + j] == ALIVE )
+            {
+                if ( alive_neighbors == 2 || alive_neighbors == 3 )
+                    to[i*p + j] = ALIVE;
+                else
+                    to[i*p + j] = DEAD;
+            }
+            else
+            {
+                if ( alive_neighbors == 3 )
+                    to[i*p + j] = ALIVE;
+                else
+                    to[i*p + j] = DEAD;
+            }
+
+            // Remember whether the tile changed
+            if ( to[i*p + j] != from[i*p + j] )
+            	changed = 1;
+		}
+
+	return changed;
+}
+
+// Function that carries a static tile over to the next generation unchanged
+void copy_tile(int *from, int *to, long long s, long long ty, long long tx)
+{
+	long long	p = s+2,
+				i0 = ty*TILE_SIZE + 1,
+				j0 = tx*TILE_SIZE + 1,
+				i1 = i0 + TILE_SIZE - 1,
+				j1 = j0 + TILE_SIZE - 1,
+				i;
+
+	// Clamp the last tile row/column to the board
+	if ( i1 > s )
+		i1 = s;
+	if ( j1 > s )
+		j1 = s;
+
+	for ( i=i0; i<=i1; i++ )
+		memcpy(&to[i*p + j0], &from[i*p + j0], (j1-j0+1) * sizeof(int));
+}
+
+// Function that print out a matrix (buffered; diffed against the previous
+// frame when stdout is a terminal)
+void print_matrix(int *m, long long s)
+{
+	render_frame(m, s, ALIVE_CHAR, DEAD_CHAR);
+}
+
+// Function that calculates the amount of alive cells in a grid
+long long cells_alive(int *m, long long s)
+{
+	long long	i,
+				j,
+				alives = 0;
+
+	for ( i=0; i<s; i++ )
+		for ( j=0; j<s; j++ )
+			if ( m[(i+1)*(s+2) + (j+1)] == ALIVE )
+				alives++;
+
+	return alives;
+}
+
+// Function that gets the current timestamp (monotonic wall clock; the old
+// clock()-based version summed CPU time across threads and made the parallel
+// numbers meaningless)
+double GetTime()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1000000000.0;
+}
@@ -0,0 +1,333 @@
+/* File:    game_tmpl.cpp
+ * Purpose: Run the Game of Life on a single thread with the kernel specialized
+ *          at compile time for the board topology and common board sizes.
+ * Compile: make -f make_game_tmpl
+ * Run:     ./game_tmpl <grid size> <number of generations> [seed] [--bounded]
+ * Input:   None
+ * Output:  Resultant generation, number of alive cells, and time spent doing calculations.
+ *
+ * Notes:
+ *  1.  Time given in seconds.
+ *  2.  The ghost border already keeps wrap checks out of the inner loop; the
+ *      topology template moves the remaining per-generation border work out of
+ *      the bounded (dead border) variant entirely, since its border is zeroed
+ *      once and never written again.
+ *  3.  Common board sizes (256/512/1024/2048/4096) dispatch to instantiations
+ *      with compile-time trip counts and a constant row pitch, so the compiler
+ *      can unroll and strength-reduce the index math; other sizes fall back to
+ *      the runtime-size instantiation.
+ *  4.  The bounded variant matches the MPI engine's plane topology.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "render.h"
+#include "prand.h"
+#include "hugealloc.h"
+#include "verify.h"
+
+// Whether or not to print matrices (1/0)
+#define PRINT_OUT 0
+
+// Cell definitions (must be integers and char*)
+#define ALIVE 		1
+#define DEAD		0
+#define ALIVE_CHAR	"▉"
+#define DEAD_CHAR	" "
+
+// Board topologies: torus wraps every border, bounded has a dead border
+enum Topology
+{
+	TORUS,
+	BOUNDED
+};
+
+// One generation step specialized for a board size (0 = runtime size)
+typedef long long (*StepFn)(int *from, int *to, long long s);
+
+// Whether to print one VERIFY checksum line per generation (--verify)
+static int verify_mode = 0;
+
+// Functions prototypes
+int 		*new_matrix(long long s);
+void 		delete_matrix(int *m);
+void 		fill_ghost_cells(int *m, long long s);
+void		print_matrix(int *m, long long s);
+double 		GetTime();
+
+// Function that generate a matrix dinamycally
+int *new_matrix(long long s)
+{
+	// Create the matrix in the memory as one contiguous block (row-major)
+	// with a one-cell ghost border on every side
+	int 		*m;
+
+	m = (int*) huge_alloc((s+2) * (s+2) * sizeof(int));
+
+    return m;
+}
+
+// Function that removes a matrix from the memory
+void delete_matrix(int *m)
+{
+	if ( m != NULL )
+	{
+		// Delete the whole matrix
+		huge_free(m);
+		m = NULL;
+	}
+}
+
+// Function that copies the wrap rows/columns into the ghost border
+void fill_ghost_cells(int *m, long long s)
+{
+	long long	k,
+				p = s+2;
+
+	// Wrap rows: top ghost row mirrors the last row, bottom ghost row the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[0*p + k] = m[s*p + k];
+		m[(s+1)*p + k] = m[1*p + k];
+	}
+
+	// Wrap columns: left ghost column mirrors the last column, right the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[k*p + 0] = m[k*p + s];
+		m[k*p + (s+1)] = m[k*p + 1];
+	}
+
+	// Wrap the four corners
+	m[0*p + 0] = m[s*p + s];
+	m[0*p + (s+1)] = m[s*p + 1];
+	m[(s+1)*p + 0] = m[1*p + s];
+	m[(s+1)*p + (s+1)] = m[1*p + 1];
+}
+
+// Function that process the next generation; with S > 0 the board size and
+// row pitch are compile-time constants, so the trip counts and index math
+// specialize per instantiation. Returns the number of alive cells written
+template <long long S>
+static long long process_generation(int *from, int *to, long long s_runtime)
+{
+	const long long	s = ( S > 0 ) ? S : s_runtime,
+					p = s+2;
+	long long		i,
+					j,
+					alive_neighbors,
+					alives = 0;
+
+	// Go through the interior of the matrix (no wrap checks needed)
+	for ( i=1; i<=s; i++ )
+		for ( j=1; j<=s; j++ )
+		{
+			// Calculate the number of neighbors alive
+			alive_neighbors =
+				from[(i-1)*p + (j-1)]	+ // Northwest
+				from[(i-1)*p + j]		+ // North
+				from[(i-1)*p + (j+1)]	+ // Northeast
+				from[i*p + (j-1)]		+ // West
+				from[i*p + (j+1)]		+ // East
+				from[(i+1)*p + (j-1)]	+ // Southwest
+				from[(i+1)*p + j]		+ // South
+				from[(i+1)*p + (j+1)];	  // Southeast
+
+			// Apply the rules
+			if ( alive_neighbors == 3 || ( alive_neighbors == 2 && from[i*p + j] == ALIVE ) )
+				to[i*p + j] = ALIVE;
+			else
+				to[i*p + j] = DEAD;
+
+			// Accumulate the population as we write
+			alives += to[i*p + j];
+		}
+
+	return alives;
+}
+
+// Function that prepares the border for the next step: the torus re-wraps
+// it every generation, the bounded board leaves its dead border alone
+template <Topology T>
+static void prepare_border(int *m, long long s)
+{
+	if ( T == TORUS )
+		fill_ghost_cells(m, s);
+}
+
+// Function that picks the step instantiation for a board size
+static StepFn pick_step(long long s)
+{
+	switch ( s )
+	{
+		case 256:	return process_generation<256>;
+		case 512:	return process_generation<512>;
+		case 1024:	return process_generation<1024>;
+		case 2048:	return process_generation<2048>;
+		case 4096:	return process_generation<4096>;
+		default:	return process_generation<0>;
+	}
+}
+
+// Function that runs the whole generation loop for one topology
+template <Topology T>
+static long long run_generations(int *&matrix, int *&next_gen, long long size, long long generations)
+{
+	StepFn		step = pick_step(size);
+	long long	i,
+				alive_count = 0;
+	int			*swap;
+
+	for ( i=0; i<generations; i++ )
+	{
+		prepare_border<T>(matrix, size);
+		alive_count = step(matrix, next_gen, size);
+
+		// Swap the matrices
+		swap = matrix;
+		matrix = next_gen;
+		next_gen = swap;
+
+		// One checksum line per generation for verify.sh
+		if ( verify_mode )
+			printf("VERIFY %lld %lld %016llx\n", i+1, alive_count, verify_board_hash(matrix, size));
+
+		// Print it out
+		if ( PRINT_OUT )
+		{
+			printf("Generation #%d (%lld alive):\n\n", (int) i+1, alive_count);
+			print_matrix(matrix, size);
+			printf("\n");
+		}
+	}
+
+	return alive_count;
+}
+
+// Main funtion
+int main(int argc, char* argv[])
+{
+	const char* usage_msg = "Usage: ./game_tmpl size generations [seed] [--bounded] [--verify]\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tseed - random seed for reproducible boards (optional)\n\t--bounded - dead border instead of the torus wrap\n\t--verify - print one VERIFY line (generation, population, board hash) per generation\n\n";
+
+	// Check the arguments
+	if ( argc < 3 )
+	{
+		printf("%s", usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Get the arguments
+	int	size = atoi(argv[1]),
+		generations = atoi(argv[2]);
+
+	// If no valid arguments were provided
+	if ( size == 0 || generations == 0 )
+	{
+		printf("%s", usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Optional arguments: seed is positional, the topology is a flag
+	unsigned int	seed = (unsigned int) time(NULL);
+	Topology		topology = TORUS;
+
+	for ( int a=3; a<argc; a++ )
+	{
+		if ( strcmp(argv[a], "--bounded") == 0 )
+			topology = BOUNDED;
+		else if ( strcmp(argv[a], "--verify") == 0 )
+			verify_mode = 1;
+		else
+			seed = (unsigned int) atoi(argv[a]);
+	}
+
+	// Program variables
+	int			*matrix = NULL,
+				*next_gen = NULL;
+	long long	i,
+				j,
+				alive_count = 0;
+	double		begin_serial,
+ 				end_serial;
+
+ 	// Timestamp when serial part starts
+ 	begin_serial = GetTime();
+
+	printf("\nGenerating matrix %dx%d (%s)... ", size, size,
+			topology == TORUS ? "torus" : "bounded");
+
+	// Create both matrices in the memory (reused for the whole run)
+	matrix = new_matrix(size);
+	next_gen = new_matrix(size);
+
+	printf("Done!\n\n");
+
+	printf("Filling out the matrix... ");
+
+    // Fill the matrix from the counter-based PRNG (pure hash of
+    // seed and cell index, no hidden state)
+    for ( i=0; i<size; i++ )
+    	for ( j=0; j<size; j++ )
+    		matrix[(i+1)*(size+2) + (j+1)] = prand_cell(seed, i, j);
+
+    printf("Done!\n");
+    printf("\nProcessing generations... ");
+
+    // Print out the matrix
+    if ( PRINT_OUT )
+    {
+    	printf("\n\nGrid %dx%d:\n\n", size, size);
+    	print_matrix(matrix, size);
+    	printf("\n");
+    }
+
+    // Process the generations with the selected topology instantiation
+    if ( topology == TORUS )
+    	alive_count = run_generations<TORUS>(matrix, next_gen, size, generations);
+    else
+    	alive_count = run_generations<BOUNDED>(matrix, next_gen, size, generations);
+
+    printf("Done!\n");
+    printf("\n-> Alive cells at the generation #%d: %lld\n\n", generations, alive_count);
+
+    // Delete the matrices from the memory
+    delete_matrix(matrix);
+    delete_matrix(next_gen);
+
+    // Timestamp when serial part ends
+ 	end_serial = GetTime();
+
+ 	double time_serial = end_serial - begin_serial;
+ 	// Show statistics about execution time
+ 	printf("____________________________________________________\n\n");
+ 	printf("Execution time (by part):\n\n");
+ 	printf("- Serial:\t%.3f seconds\n", (double) time_serial);
+ 	printf("- Total:\t%.3f seconds\n", (double) time_serial);
+
+	// End of the program
+	return EXIT_SUCCESS;
+}
+
+// Function that print out a matrix (buffered; diffed against the previous
+// frame when stdout is a terminal)
+void print_matrix(int *m, long long s)
+{
+	render_frame(m, s, ALIVE_CHAR, DEAD_CHAR);
+}
+
+// Function that gets the current timestamp (monotonic wall clock; the old
+// clock()-based version summed CPU time across threads and made the parallel
+// numbers meaningless)
+double GetTime()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1000000000.0;
+}
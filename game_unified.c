@@ -0,0 +1,735 @@
+/* File:    game_unified.c
+ * Purpose: Run the Game of Life with the backend chosen at runtime, so every
+ *          engine shares one grid layout, one initialization path and one
+ *          timing/reporting path.
+ * Compile: make game_unified
+ * Run:     ./game_unified <grid size> <number of generations> <threads> [--engine=serial|omp|pthread]
+ * Input:   None
+ * Output:  Resultant generation, number of alive cells, and time spent doing calculations.
+ *
+ * Notes:
+ *  1.  Time given in seconds.
+ *  2.  The step kernels are the ones from game.c (column-blocked, AVX2 when
+ *      available), game_omp.c (guided cache-sized tiles) and game_pthread.c
+ *      (persistent pool pulling tiles off a shared queue); only the code
+ *      around them — allocation, fill, ghost border, loop, stats — is shared,
+ *      so backend comparisons measure the kernels and nothing else.
+ *  3.  The MPI engine stays a separate binary (MPI/game_mpi): it needs the
+ *      MPI toolchain and an mpirun launcher, which a --engine flag cannot
+ *      provide. The historic single-engine binaries still build as before.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rle.h"
+#include "render.h"
+#include "prand.h"
+#include "hugealloc.h"
+#include "verify.h"
+#include <omp.h>
+#include <pthread.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Maximum number of threads allowed (>0)
+#define MAX_THREADS 200
+
+// Whether or not to print matrices (1/0)
+#define PRINT_OUT 0
+
+// Cell definitions (must be integers and char*)
+#define ALIVE 		1
+#define DEAD		0
+#define ALIVE_CHAR	"▉"
+#define DEAD_CHAR	" "
+
+// Tile width in cells: three source rows plus the output row of one tile
+// stay resident in L2 while the tile is processed
+#define COL_BLOCK 2048
+
+// Tile height in rows for the pthread queue: big enough to keep the shared
+// counter cold, small enough to balance the tail
+#define ROW_BLOCK 16
+
+// Minimum tile height for the guided OpenMP schedule
+#define MIN_ROW_BLOCK 4
+
+// Available backends
+typedef enum Engine
+{
+	ENGINE_SERIAL,
+	ENGINE_OMP,
+	ENGINE_PTHREAD
+} Engine;
+
+// Datatype for passing arguments to the pthread workers
+typedef struct Args
+{
+    int 		t_number;
+    long long	size;
+    long long	alives;
+    double		busy;
+} Args;
+
+// Shared state of the persistent pthread pool: the main thread publishes the
+// grids for the next generation, then everybody meets on the barrier; the
+// workers pull tiles from the shared queue counter until it drains
+int					*shared_from = NULL,
+					*shared_to = NULL;
+long long			shared_next_tile = 0;
+int					shared_generations = 0;
+pthread_barrier_t	barrier;
+
+// Context for streaming RLE pattern cells into the padded grid
+typedef struct RleGrid
+{
+    int 		*m;
+    long long	size;
+} RleGrid;
+
+// Function that writes one alive pattern cell into the grid (clipped to it)
+static void rle_set_cell(void *ctx, long long row, long long col)
+{
+	RleGrid	*g = (RleGrid*) ctx;
+
+	if ( row < g->size && col < g->size )
+		g->m[(row+1)*(g->size+2) + (col+1)] = ALIVE;
+}
+
+// Functions prototypes
+int 		*new_matrix(long long s);
+void 		delete_matrix(int *m);
+void 		fill_ghost_cells(int *m, long long s);
+long long	step_serial(int *from, int *to, long long s);
+long long	step_omp(int *from, int *to, long long s);
+void 		*pthread_worker(void *thread_arg);
+void		print_matrix(int *m, long long s);
+double 		GetTime();
+
+// Main funtion
+int main(int argc, char* argv[])
+{
+	char* usage_msg = "Usage: ./game_unified size generations threads [seed] [pattern.rle] [--engine=serial|omp|pthread] [--verify]\n\n\tsize - matrix size (> 0)\n\tgenerations - number of generations to compute\n\tthreads - number of threads (> 0; the serial engine ignores it)\n\tseed - random seed for reproducible boards (optional)\n\tpattern - RLE pattern file to load instead of a random board (optional)\n\t--engine - backend to run the generations with (default: serial)\n\t--verify - print one VERIFY line (generation, population, board hash) per generation\n\n";
+
+	// Check the arguments
+	if ( argc < 4 )
+	{
+		printf(usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Get the arguments
+	long long	size = atoi(argv[1]);
+	int			generations = atoi(argv[2]),
+				thread_count = atoi(argv[3]);
+
+	// If no valid arguments were provided
+	if ( size == 0 || generations == 0 || thread_count == 0 )
+	{
+		printf(usage_msg);
+
+		return EXIT_FAILURE;
+	}
+
+	// Seed the random number generator (a fixed seed gives reproducible boards)
+	unsigned int seed = (unsigned int) time(NULL);
+
+	// Optional arguments: seed and pattern are positional, the engine
+	// selector and --verify are flags
+	char	*pattern_file = NULL;
+	Engine	engine = ENGINE_SERIAL;
+	int		verify_mode = 0,
+			positionals = 0,
+			a;
+
+	for ( a=4; a<argc; a++ )
+	{
+		if ( strncmp(argv[a], "--engine=", 9) == 0 )
+		{
+			if ( strcmp(argv[a]+9, "serial") == 0 )
+				engine = ENGINE_SERIAL;
+			else if ( strcmp(argv[a]+9, "omp") == 0 )
+				engine = ENGINE_OMP;
+			else if ( strcmp(argv[a]+9, "pthread") == 0 )
+				engine = ENGINE_PTHREAD;
+			else if ( strcmp(argv[a]+9, "mpi") == 0 )
+			{
+				printf("\nThe MPI engine is a separate binary: build it with 'make mpi' and launch it with mpirun (e.g. mpirun -np 4 MPI/game_mpi %s %s).\n\n", argv[1], argv[2]);
+
+				return EXIT_FAILURE;
+			}
+			else
+			{
+				printf("\nUnknown engine '%s'.\n\n%s", argv[a]+9, usage_msg);
+
+				return EXIT_FAILURE;
+			}
+		}
+		else if ( strcmp(argv[a], "--verify") == 0 )
+			verify_mode = 1;
+		else if ( positionals == 0 )
+		{
+			seed = (unsigned int) atoi(argv[a]);
+			positionals++;
+		}
+		else
+		{
+			pattern_file = argv[a];
+			positionals++;
+		}
+	}
+
+	// Program variables
+	int			*matrix = NULL,
+				*next_gen = NULL,
+				*swap = NULL;
+	long long	i,
+				j,
+				alive_count = 0;
+	pthread_t	*thread_handles = NULL;
+	Args		*args = NULL;
+	double		begin_serial,
+ 				end_serial,
+ 				begin_parallel,
+ 				end_parallel;
+
+ 	// Timestamp when serial part starts
+ 	begin_serial = GetTime();
+
+ 	// Calculate the correct number of threads
+	if ( thread_count > MAX_THREADS )
+	{
+	 	thread_count = MAX_THREADS;
+
+	 	printf("\n[!] Number of threads lowered to %d (maximum threads limit).\n", MAX_THREADS);
+	}
+
+	printf("\n> Engine: %s", engine == ENGINE_SERIAL ? "serial" :
+			engine == ENGINE_OMP ? "omp" : "pthread");
+
+	if ( engine != ENGINE_SERIAL )
+		printf(" (%d threads)", thread_count);
+
+	printf("\n");
+
+	if ( engine == ENGINE_OMP )
+		omp_set_num_threads(thread_count);
+
+	printf("\nGenerating matrix %lldx%lld... ", size, size);
+
+	// Create both matrices in the memory (reused for the whole run)
+	matrix = new_matrix(size);
+	next_gen = new_matrix(size);
+
+	printf("Done!\n\n");
+
+	printf("Filling out the matrix... ");
+
+    if ( pattern_file != NULL )
+    {
+    	// Decode the RLE pattern straight into the grid (background stays dead)
+    	RleGrid		ctx = { matrix, size };
+    	long long	pat_w = 0,
+    				pat_h = 0;
+
+    	if ( rle_load(pattern_file, &pat_w, &pat_h, rle_set_cell, &ctx) != 0 )
+    	{
+    		printf("Unable to load the pattern %s!\n\n", pattern_file);
+
+    		return EXIT_FAILURE;
+    	}
+
+    	if ( pat_w > size || pat_h > size )
+    		printf("\n[!] Pattern (%lldx%lld) is larger than the board and was clipped.\n", pat_w, pat_h);
+    }
+    else
+    {
+	    // Fill the matrix from the counter-based PRNG (pure hash of
+	    // seed and cell index, no hidden state)
+	    for ( i=0; i<size; i++ )
+	    	for ( j=0; j<size; j++ )
+	    		matrix[(i+1)*(size+2) + (j+1)] = prand_cell(seed, i, j);
+	}
+
+    printf("Done!\n");
+    printf("\nProcessing generations... ");
+
+    // Print out the matrix
+    if ( PRINT_OUT )
+    {
+    	printf("\n\nGrid %lldx%lld:\n\n", size, size);
+    	print_matrix(matrix, size);
+    	printf("\n");
+    }
+
+    /************* BEGIN PARALLEL ****************/
+
+ 	// Timestamp when parallel part starts
+ 	begin_parallel = GetTime();
+
+ 	if ( engine == ENGINE_PTHREAD )
+ 	{
+	 	// The main thread waits on the barrier too, so count it in
+	 	pthread_barrier_init(&barrier, NULL, thread_count+1);
+
+	 	// Number of generations every worker will process
+	 	shared_generations = generations;
+
+	 	// Create the persistent workers once; they park on the barrier
+	 	// between generations instead of being created and joined each step
+	 	thread_handles = (pthread_t*) malloc(thread_count * sizeof(pthread_t));
+	 	args = (Args*) malloc(thread_count * sizeof(Args));
+
+		for ( j=0; j<thread_count; j++ )
+		{
+		 	args[j].t_number = j;
+		 	args[j].size = size;
+		 	args[j].busy = 0.0;
+
+		 	pthread_create(&thread_handles[j], NULL, pthread_worker, (void*)&args[j]);
+		}
+	}
+
+ 	// Process the generations
+    for ( i=0; i<generations; i++ )
+    {
+	    // Copy the wrap rows/columns into the ghost border
+	    fill_ghost_cells(matrix, size);
+
+	    // Process the next generation with the selected backend
+	    switch ( engine )
+	    {
+	    	case ENGINE_SERIAL:
+	    		alive_count = step_serial(matrix, next_gen, size);
+	    		break;
+
+	    	case ENGINE_OMP:
+	    		alive_count = step_omp(matrix, next_gen, size);
+	    		break;
+
+	    	case ENGINE_PTHREAD:
+	    		// Publish the grids for this generation, refill the tile
+	    		// queue and release the workers
+	    		shared_from = matrix;
+	    		shared_to = next_gen;
+	    		shared_next_tile = 0;
+	    		pthread_barrier_wait(&barrier);
+
+	    		// Wait until every worker finished its slice
+	    		pthread_barrier_wait(&barrier);
+
+	    		// Reduce the per-worker population partials
+	    		alive_count = 0;
+	    		for ( j=0; j<thread_count; j++ )
+	    			alive_count += args[j].alives;
+
+	    		break;
+	    }
+
+    	// Swap the matrices
+	    swap = matrix;
+	    matrix = next_gen;
+	    next_gen = swap;
+
+    	// One checksum line per generation for verify.sh
+    	if ( verify_mode )
+    		printf("VERIFY %lld %lld %016llx\n", i+1, alive_count, verify_board_hash(matrix, size));
+
+    	// Print it out
+    	if ( PRINT_OUT )
+	    {
+	    	printf("Generation #%d (%lld alive):\n\n", (int) i+1, alive_count);
+	    	print_matrix(matrix, size);
+	    	printf("\n");
+	    }
+    }
+
+ 	if ( engine == ENGINE_PTHREAD )
+ 	{
+		// Join all threads (they exit after the last generation)
+		for ( j=0; j<thread_count; j++ )
+			pthread_join(thread_handles[j], NULL);
+
+		pthread_barrier_destroy(&barrier);
+	}
+
+    // Timestamp when parallel part ends
+ 	end_parallel = GetTime();
+
+ 	/************** END PARALLEL *****************/
+
+    printf("Done!\n");
+    printf("\n-> Alive cells at the generation #%d: %lld\n\n", generations, alive_count);
+
+    // Delete the matrices from the memory
+    delete_matrix(matrix);
+    delete_matrix(next_gen);
+
+    // Timestamp when serial part ends
+ 	end_serial = GetTime();
+
+ 	// Calculate each time spent
+ 	double time_parallel = end_parallel - begin_parallel;
+ 	double time_serial = end_serial - begin_serial;
+ 	// Show statistics about execution time
+ 	printf("____________________________________________________\n\n");
+ 	printf("Execution time (by part):\n\n");
+ 	printf("- Serial:\t%.3f seconds\n", (double) time_serial-time_parallel);
+ 	printf("- Parallel:\t%.3f seconds\n", (double) time_parallel);
+ 	printf("- Total:\t%.3f seconds\n", (double) time_serial);
+
+ 	// Busy time per worker exposes load imbalance between the tiles
+ 	if ( engine == ENGINE_PTHREAD )
+ 	{
+	 	printf("\nPer-thread busy time:\n\n");
+	 	for ( j=0; j<thread_count; j++ )
+	 		printf("- Thread #%d:\t%.3f seconds\n", (int) j+1, args[j].busy);
+	}
+
+ 	free(thread_handles);
+ 	free(args);
+
+	// End of the program
+	return EXIT_SUCCESS;
+}
+
+// Function that generate a matrix dinamycally
+int *new_matrix(long long s)
+{
+	// Create the matrix in the memory as one contiguous block (row-major)
+	// with a one-cell ghost border on every side
+	int 		*m;
+
+	m = (int*) huge_alloc((s+2) * (s+2) * sizeof(int));
+
+    return m;
+}
+
+// Function that removes a matrix from the memory
+void delete_matrix(int *m)
+{
+	if ( m != NULL )
+	{
+		// Delete the whole matrix
+		huge_free(m);
+		m = NULL;
+	}
+}
+
+// Function that copies the wrap rows/columns into the ghost border
+void fill_ghost_cells(int *m, long long s)
+{
+	long long	k,
+				p = s+2;
+
+	// Wrap rows: top ghost row mirrors the last row, bottom ghost row the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[0*p + k] = m[s*p + k];
+		m[(s+1)*p + k] = m[1*p + k];
+	}
+
+	// Wrap columns: left ghost column mirrors the last column, right the first
+	for ( k=1; k<=s; k++ )
+	{
+		m[k*p + 0] = m[k*p + s];
+		m[k*p + (s+1)] = m[k*p + 1];
+	}
+
+	// Wrap the four corners
+	m[0*p + 0] = m[s*p + s];
+	m[0*p + (s+1)] = m[s*p + 1];
+	m[(s+1)*p + 0] = m[1*p + s];
+	m[(s+1)*p + (s+1)] = m[1*p + 1];
+}
+
+#if defined(__x86_64__)
+// Function that process columns j0..j1 of one interior row, 8 cells at a
+// time, using AVX2; returns the number of alive cells written
+__attribute__((target("avx2")))
+static long long process_row_avx2(int *up, int *mid, int *down, int *out, long long j0, long long j1)
+{
+	long long	j = j0,
+				alives = 0;
+	__m256i		acc = _mm256_setzero_si256(),
+				two = _mm256_set1_epi32(2),
+				three = _mm256_set1_epi32(3),
+				one = _mm256_set1_epi32(ALIVE);
+
+	// Compute 8 neighbor counts per iteration with packed adds,
+	// then apply the rules with compares and blends
+	for ( ; j+7 <= j1; j += 8 )
+	{
+		__m256i	sum = _mm256_add_epi32(
+					_mm256_loadu_si256((__m256i const*)&up[j-1]),
+					_mm256_loadu_si256((__m256i const*)&up[j]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&up[j+1]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&mid[j-1]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&mid[j+1]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&down[j-1]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&down[j]));
+		sum = _mm256_add_epi32(sum, _mm256_loadu_si256((__m256i const*)&down[j+1]));
+
+		__m256i	center = _mm256_loadu_si256((__m256i const*)&mid[j]);
+		__m256i	birth = _mm256_cmpeq_epi32(sum, three);
+		__m256i	survive = _mm256_and_si256(_mm256_cmpeq_epi32(sum, two),
+					_mm256_cmpeq_epi32(center, one));
+
+		// Turn the compare masks back into ALIVE/DEAD ints
+		__m256i	next = _mm256_and_si256(_mm256_or_si256(birth, survive), one);
+		_mm256_storeu_si256((__m256i*)&out[j], next);
+
+		// Accumulate the population as we write
+		acc = _mm256_add_epi32(acc, next);
+	}
+
+	// Reduce the per-lane population counters
+	{
+		int	lanes[8];
+
+		_mm256_storeu_si256((__m256i*)lanes, acc);
+		alives = (long long) lanes[0] + lanes[1] + lanes[2] + lanes[3]
+				+ lanes[4] + lanes[5] + lanes[6] + lanes[7];
+	}
+
+	// Scalar tail for the last few columns of the block
+	for ( ; j<=j1; j++ )
+	{
+		int	alive_neighbors =
+				up[j-1] + up[j] + up[j+1] +
+				mid[j-1] + mid[j+1] +
+				down[j-1] + down[j] + down[j+1];
+
+		if ( alive_neighbors == 3 || ( alive_neighbors == 2 && mid[j] == ALIVE ) )
+			out[j] = ALIVE;
+		else
+			out[j] = DEAD;
+
+		alives += out[j];
+	}
+
+	return alives;
+}
+#endif
+
+// Function that process the next generation on one thread (game.c's kernel:
+// COL_BLOCK-wide column strips, AVX2 rows when the CPU has it); returns the
+// number of alive cells in the new generation, counted while it is written
+long long step_serial(int *from, int *to, long long s)
+{
+	long long	i,
+				j,
+				j0,
+				j1,
+				p = s+2,
+				alive_neighbors = 0,
+				alives = 0;
+
+#if defined(__x86_64__)
+	// Detect AVX2 once at runtime; without it we fall through to the scalar path
+	static int	use_avx2 = -1;
+
+	if ( use_avx2 < 0 )
+		use_avx2 = __builtin_cpu_supports("avx2");
+
+	if ( use_avx2 )
+	{
+		for ( j0=1; j0<=s; j0+=COL_BLOCK )
+		{
+			j1 = ( j0+COL_BLOCK-1 <= s ) ? j0+COL_BLOCK-1 : s;
+
+			for ( i=1; i<=s; i++ )
+				alives += process_row_avx2(&from[(i-1)*p], &from[i*p], &from[(i+1)*p], &to[i*p], j0, j1);
+		}
+
+		return alives;
+	}
+#endif
+
+	// Go through the interior of the matrix (no wrap checks needed),
+	// one column block at a time
+	for ( j0=1; j0<=s; j0+=COL_BLOCK )
+	{
+		j1 = ( j0+COL_BLOCK-1 <= s ) ? j0+COL_BLOCK-1 : s;
+
+		for ( i=1; i<=s; i++ )
+			for ( j=j0; j<=j1; j++ )
+			{
+				// Calculate the number of neighbors alive
+				alive_neighbors =
+					from[(i-1)*p + (j-1)]	+ // Northwest
+					from[(i-1)*p + j]		+ // North
+					from[(i-1)*p + (j+1)]	+ // Northeast
+					from[i*p + (j-1)]		+ // West
+					from[i*p + (j+1)]		+ // East
+					from[(i+1)*p + (j-1)]	+ // Southwest
+					from[(i+1)*p + j]		+ // South
+					from[(i+1)*p + (j+1)];	  // Southeast
+
+				// Apply the rules
+				if ( alive_neighbors == 3 || ( alive_neighbors == 2 && from[i*p + j] == ALIVE ) )
+					to[i*p + j] = ALIVE;
+				else
+					to[i*p + j] = DEAD;
+
+				// Accumulate the population as we write
+				alives += to[i*p + j];
+			}
+	}
+
+	return alives;
+}
+
+// Function that process the next generation with OpenMP (game_omp.c's kernel:
+// cache-sized tiles on a guided schedule); returns the number of alive cells
+// in the new generation, counted while it is written
+long long step_omp(int *from, int *to, long long s)
+{
+	long long	p = s+2,
+				alives = 0;
+
+	long long	col_blocks = (s + COL_BLOCK - 1) / COL_BLOCK,
+				row_blocks = (s + MIN_ROW_BLOCK - 1) / MIN_ROW_BLOCK;
+
+	#pragma omp parallel reduction(+: alives)
+	{
+		long long	i,
+					j,
+					t,
+					alive_neighbors;
+
+		// Go through the interior of the matrix (no wrap checks needed),
+		// one cache-sized tile per scheduled chunk
+		#pragma omp for schedule(guided) nowait
+		for ( t=0; t<row_blocks*col_blocks; t++ )
+		{
+			long long	i0 = (t / col_blocks) * MIN_ROW_BLOCK + 1,
+						i1 = ( i0+MIN_ROW_BLOCK-1 <= s ) ? i0+MIN_ROW_BLOCK-1 : s,
+						j0 = (t % col_blocks) * COL_BLOCK + 1,
+						j1 = ( j0+COL_BLOCK-1 <= s ) ? j0+COL_BLOCK-1 : s;
+
+			for ( i=i0; i<=i1; i++ )
+				for ( j=j0; j<=j1; j++ )
+				{
+					// Calculate the number of neighbors alive
+					alive_neighbors =
+						from[(i-1)*p + (j-1)]	+ // Northwest
+						from[(i-1)*p + j]		+ // North
+						from[(i-1)*p + (j+1)]	+ // Northeast
+						from[i*p + (j-1)]		+ // West
+						from[i*p + (j+1)]		+ // East
+						from[(i+1)*p + (j-1)]	+ // Southwest
+						from[(i+1)*p + j]		+ // South
+						from[(i+1)*p + (j+1)];	  // Southeast
+
+					// Apply the rules
+					if ( alive_neighbors == 3 || ( alive_neighbors == 2 && from[i*p + j] == ALIVE ) )
+						to[i*p + j] = ALIVE;
+					else
+						to[i*p + j] = DEAD;
+
+					// Accumulate this thread's share of the population
+					alives += to[i*p + j];
+				}
+		}
+	}
+
+	return alives;
+}
+
+// Function run by each persistent pthread worker (game_pthread.c's kernel):
+// pulls cache-sized tiles from the shared queue every generation, meeting the
+// main thread on the barrier before and after each one
+void *pthread_worker(void *thread_arg)
+{
+	Args 		*arg = (Args*) thread_arg;
+	long long	i,
+				j,
+				g,
+				t,
+				s = arg->size,
+				p = s+2,
+				alive_neighbors = 0,
+				col_blocks = (s + COL_BLOCK - 1) / COL_BLOCK,
+				tiles = ((s + ROW_BLOCK - 1) / ROW_BLOCK) * col_blocks;
+
+	// Process every generation, parked on the barrier in between
+	for ( g=0; g<shared_generations; g++ )
+	{
+		// Wait for the main thread to publish the grids
+		pthread_barrier_wait(&barrier);
+
+		int			*from = shared_from,
+					*to = shared_to;
+		long long	alives = 0;
+		double		busy_start = GetTime();
+
+		// Pull cache-sized tiles off the shared queue until the generation
+		// drains; whichever thread finishes a tile first grabs the next one
+		while ( (t = __sync_fetch_and_add(&shared_next_tile, 1)) < tiles )
+		{
+			long long	i0 = (t / col_blocks) * ROW_BLOCK + 1,
+						i1 = ( i0+ROW_BLOCK-1 <= s ) ? i0+ROW_BLOCK-1 : s,
+						j0 = (t % col_blocks) * COL_BLOCK + 1,
+						j1 = ( j0+COL_BLOCK-1 <= s ) ? j0+COL_BLOCK-1 : s;
+
+			// Go through the interior of this tile (no wrap checks needed)
+			for ( i=i0; i<=i1; i++ )
+				for ( j=j0; j<=j1; j++ )
+				{
+					// Calculate the number of neighbors alive
+					alive_neighbors =
+						from[(i-1)*p + (j-1)]	+ // Northwest
+						from[(i-1)*p + j]		+ // North
+						from[(i-1)*p + (j+1)]	+ // Northeast
+						from[i*p + (j-1)]		+ // West
+						from[i*p + (j+1)]		+ // East
+						from[(i+1)*p + (j-1)]	+ // Southwest
+						from[(i+1)*p + j]		+ // South
+						from[(i+1)*p + (j+1)];	  // Southeast
+
+					// Apply the rules
+					if ( alive_neighbors == 3 || ( alive_neighbors == 2 && from[i*p + j] == ALIVE ) )
+						to[i*p + j] = ALIVE;
+					else
+						to[i*p + j] = DEAD;
+
+					// Accumulate this worker's share of the population
+					alives += to[i*p + j];
+				}
+		}
+
+		// Publish the partial and busy time, then signal that this slice is done
+		arg->alives = alives;
+		arg->busy += GetTime() - busy_start;
+		pthread_barrier_wait(&barrier);
+	}
+
+	// Terminate the thread
+	pthread_exit(NULL);
+}
+
+// Function that print out a matrix (buffered; diffed against the previous
+// frame when stdout is a terminal)
+void print_matrix(int *m, long long s)
+{
+	render_frame(m, s, ALIVE_CHAR, DEAD_CHAR);
+}
+
+// Function that gets the current timestamp (monotonic wall clock; the old
+// clock()-based version summed CPU time across threads and made the parallel
+// numbers meaningless)
+double GetTime()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec / 1000000000.0;
+}
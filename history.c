@@ -0,0 +1,447 @@
+/* File:    history.c
+ * Purpose: Streaming run history with bounded memory (see history.h).
+ *
+ * Notes:
+ *  1.  Frames ride on the checkpoint packing (1 bit per cell, LSB-first,
+ *      (s+7)/8 bytes per row), so a frame's payload is at most size*(s+7)/8
+ *      bytes and a delta frame of a quiet board is almost all zero bytes,
+ *      which the run-length encoding collapses to next to nothing.
+ *  2.  Appends go through stdio, so frame writes batch into page-sized
+ *      writes without any extra buffering here.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "checkpoint.h"
+#include "history.h"
+
+// Frame types
+#define FRAME_KEY	0
+#define FRAME_DELTA	1
+
+// On-disk frame header: generation, type, payload bytes
+#define FRAME_HEADER_BYTES	20
+
+// Writer state: the previous packed board is all that deltas need, so the
+// memory held stays the same whether the run lasts ten generations or 100k
+static FILE				*hist_file = NULL;
+static long long		hist_size = 0,
+						hist_frames = 0;
+static unsigned char	*prev_packed = NULL,
+						*cur_packed = NULL,
+						*rle_buf = NULL;
+static long long		*key_index = NULL;	// Pairs of (generation, offset)
+static long long		key_count = 0,
+						key_cap = 0;
+
+// Function that packs the interior cells 1 bit each into out (zeroed first)
+static void pack_board(const int *m, long long s, unsigned char *out)
+{
+	long long	row_bytes = checkpoint_row_bytes(s),
+				p = s+2,
+				i,
+				j;
+
+	memset(out, 0, s * row_bytes);
+
+	for ( i=0; i<s; i++ )
+	{
+		unsigned char *row = out + i * row_bytes;
+
+		for ( j=0; j<s; j++ )
+			if ( m[(i+1)*p + (j+1)] )
+				row[j/8] |= (unsigned char) (1u << (j % 8));
+	}
+}
+
+// Function that run-length encodes n bytes as (count, value) pairs; returns
+// the encoded length (at most 2n)
+static long long rle_encode(const unsigned char *src, long long n, unsigned char *dst)
+{
+	long long	i = 0,
+				out = 0,
+				run;
+
+	while ( i < n )
+	{
+		run = 1;
+
+		while ( i+run < n && src[i+run] == src[i] && run < 255 )
+			run++;
+
+		dst[out++] = (unsigned char) run;
+		dst[out++] = src[i];
+		i += run;
+	}
+
+	return out;
+}
+
+// Function that decodes len encoded bytes into exactly n output bytes;
+// returns 0 on success
+static int rle_decode(const unsigned char *src, long long len, unsigned char *dst, long long n)
+{
+	long long	i,
+				out = 0,
+				run;
+
+	for ( i=0; i+1<len; i+=2 )
+	{
+		run = src[i];
+
+		if ( run == 0 || out + run > n )
+			return 1;
+
+		memset(dst + out, src[i+1], run);
+		out += run;
+	}
+
+	return ( out == n ) ? 0 : 1;
+}
+
+// Function that fills in a history header
+static void fill_header(unsigned char *h, long long s, long long start_gen)
+{
+	uint32_t	version = HISTORY_VERSION;
+	int64_t		size64 = s,
+				gen64 = start_gen;
+
+	memcpy(h, HISTORY_MAGIC, 4);
+	memcpy(h+4, &version, 4);
+	memcpy(h+8, &size64, 8);
+	memcpy(h+16, &gen64, 8);
+}
+
+// Function that opens path for recording; returns 0 on success
+int history_begin(const char *path, long long s, long long start_gen)
+{
+	unsigned char	header[HISTORY_HEADER_BYTES];
+	long long		packed = s * checkpoint_row_bytes(s);
+
+	history_finish();
+
+	hist_file = fopen(path, "wb");
+
+	if ( hist_file == NULL )
+		return 1;
+
+	fill_header(header, s, start_gen);
+
+	if ( fwrite(header, 1, HISTORY_HEADER_BYTES, hist_file) != HISTORY_HEADER_BYTES )
+	{
+		history_finish();
+
+		return 1;
+	}
+
+	// The previous board, the current board and the worst-case encoding
+	prev_packed = (unsigned char*) malloc(packed);
+	cur_packed = (unsigned char*) malloc(packed);
+	rle_buf = (unsigned char*) malloc(2 * packed);
+
+	if ( prev_packed == NULL || cur_packed == NULL || rle_buf == NULL )
+	{
+		history_finish();
+
+		return 1;
+	}
+
+	hist_size = s;
+	hist_frames = 0;
+	key_count = 0;
+
+	return 0;
+}
+
+// Function that appends one generation's board as a compressed frame;
+// returns 0 on success
+int history_append(const int *m, long long s, long long generation)
+{
+	unsigned char	frame[FRAME_HEADER_BYTES];
+	long long		packed = s * checkpoint_row_bytes(s),
+					len,
+					i;
+	int64_t			gen64 = generation,
+					len64;
+	uint32_t		type;
+
+	if ( hist_file == NULL || s != hist_size )
+		return 1;
+
+	pack_board(m, s, cur_packed);
+
+	if ( hist_frames % HISTORY_KEYFRAME == 0 )
+	{
+		// Keyframe: the packed board itself, remembered in the seek index
+		type = FRAME_KEY;
+
+		if ( key_count == key_cap )
+		{
+			key_cap = ( key_cap == 0 ) ? 64 : key_cap * 2;
+			key_index = (long long*) realloc(key_index, key_cap * 2 * sizeof(long long));
+		}
+
+		key_index[key_count*2] = generation;
+		key_index[key_count*2 + 1] = (long long) ftell(hist_file);
+		key_count++;
+
+		len = rle_encode(cur_packed, packed, rle_buf);
+	}
+	else
+	{
+		// Delta frame: XOR against the previous board, then encode; the
+		// previous packed copy doubles as the XOR scratch since it is
+		// replaced right after
+		for ( i=0; i<packed; i++ )
+			prev_packed[i] ^= cur_packed[i];
+
+		type = FRAME_DELTA;
+		len = rle_encode(prev_packed, packed, rle_buf);
+	}
+
+	len64 = len;
+	memcpy(frame, &gen64, 8);
+	memcpy(frame+8, &type, 4);
+	memcpy(frame+12, &len64, 8);
+
+	if ( fwrite(frame, 1, FRAME_HEADER_BYTES, hist_file) != FRAME_HEADER_BYTES
+			|| fwrite(rle_buf, 1, len, hist_file) != (size_t) len )
+		return 1;
+
+	memcpy(prev_packed, cur_packed, packed);
+	hist_frames++;
+
+	return 0;
+}
+
+// Function that appends the keyframe index and closes the history file
+void history_finish()
+{
+	if ( hist_file != NULL )
+	{
+		unsigned char	trailer[12];
+		int64_t			count64 = key_count,
+						index_offset = (int64_t) ftell(hist_file);
+
+		// Index: the keyframe count, the (generation, offset) pairs, then a
+		// trailer pointing back at the index
+		fwrite(&count64, 1, 8, hist_file);
+		fwrite(key_index, sizeof(long long), key_count * 2, hist_file);
+
+		memcpy(trailer, HISTORY_INDEX_MAGIC, 4);
+		memcpy(trailer+4, &index_offset, 8);
+		fwrite(trailer, 1, 12, hist_file);
+
+		fclose(hist_file);
+		hist_file = NULL;
+	}
+
+	free(prev_packed);
+	free(cur_packed);
+	free(rle_buf);
+	free(key_index);
+	prev_packed = NULL;
+	cur_packed = NULL;
+	rle_buf = NULL;
+	key_index = NULL;
+	key_count = 0;
+	key_cap = 0;
+	hist_size = 0;
+	hist_frames = 0;
+}
+
+// Function that reads one frame header; returns 0 on success
+static int read_frame_header(FILE *f, long long *generation, uint32_t *type, long long *len)
+{
+	unsigned char	frame[FRAME_HEADER_BYTES];
+	int64_t			gen64,
+					len64;
+
+	if ( fread(frame, 1, FRAME_HEADER_BYTES, f) != FRAME_HEADER_BYTES )
+		return 1;
+
+	memcpy(&gen64, frame, 8);
+	memcpy(type, frame+8, 4);
+	memcpy(&len64, frame+12, 8);
+	*generation = gen64;
+	*len = len64;
+
+	return 0;
+}
+
+// Function that finds the offset of the nearest keyframe at or before the
+// target generation: through the trailer index when the file has one,
+// otherwise by scanning the frame headers; returns 0 on success
+static int find_keyframe(FILE *f, long long generation, long long *offset)
+{
+	unsigned char	trailer[12];
+	int64_t			index_offset,
+					count64;
+	long long		best = -1,
+					gen,
+					len,
+					i;
+	uint32_t		type;
+
+	if ( fseek(f, -12, SEEK_END) == 0
+			&& fread(trailer, 1, 12, f) == 12
+			&& memcmp(trailer, HISTORY_INDEX_MAGIC, 4) == 0 )
+	{
+		// Indexed: walk the (generation, offset) pairs
+		memcpy(&index_offset, trailer+4, 8);
+
+		if ( fseek(f, (long) index_offset, SEEK_SET) != 0
+				|| fread(&count64, 1, 8, f) != 8 )
+			return 1;
+
+		for ( i=0; i<count64; i++ )
+		{
+			long long pair[2];
+
+			if ( fread(pair, sizeof(long long), 2, f) != 2 )
+				return 1;
+
+			if ( pair[0] <= generation )
+				best = pair[1];
+		}
+	}
+	else
+	{
+		// No trailer (the run was cut short): scan the frame headers,
+		// skipping the payloads
+		if ( fseek(f, HISTORY_HEADER_BYTES, SEEK_SET) != 0 )
+			return 1;
+
+		for ( ;; )
+		{
+			long long here = (long long) ftell(f);
+
+			if ( read_frame_header(f, &gen, &type, &len) != 0 || gen > generation )
+				break;
+
+			if ( type == FRAME_KEY )
+				best = here;
+
+			if ( fseek(f, (long) len, SEEK_CUR) != 0 )
+				break;
+		}
+	}
+
+	if ( best < 0 )
+		return 1;
+
+	*offset = best;
+
+	return 0;
+}
+
+// Function that loads the board at one recorded generation, replaying the
+// deltas from the nearest keyframe; returns 0 on success
+int history_seek(const char *path, int *m, long long s, long long generation, long long *alive_count)
+{
+	unsigned char	header[HISTORY_HEADER_BYTES],
+					*board = NULL,
+					*delta = NULL,
+					*payload = NULL;
+	long long		row_bytes = checkpoint_row_bytes(s),
+					packed = s * row_bytes,
+					p = s+2,
+					offset,
+					gen,
+					len,
+					alives = 0,
+					i,
+					j;
+	int64_t			size64;
+	uint32_t		version,
+					type;
+	FILE			*f;
+	int				found = 0;
+
+	f = fopen(path, "rb");
+
+	if ( f == NULL )
+		return 1;
+
+	// Validate the header against the requested board size
+	if ( fread(header, 1, HISTORY_HEADER_BYTES, f) != HISTORY_HEADER_BYTES
+			|| memcmp(header, HISTORY_MAGIC, 4) != 0 )
+	{
+		fclose(f);
+
+		return 1;
+	}
+
+	memcpy(&version, header+4, 4);
+	memcpy(&size64, header+8, 8);
+
+	if ( version != HISTORY_VERSION || size64 != s
+			|| find_keyframe(f, generation, &offset) != 0
+			|| fseek(f, (long) offset, SEEK_SET) != 0 )
+	{
+		fclose(f);
+
+		return 1;
+	}
+
+	board = (unsigned char*) malloc(packed);
+	delta = (unsigned char*) malloc(packed);
+	payload = (unsigned char*) malloc(2 * packed);
+
+	// Replay from the keyframe: decode every frame and XOR the deltas in
+	// until the target generation materializes
+	while ( board != NULL && delta != NULL && payload != NULL )
+	{
+		if ( read_frame_header(f, &gen, &type, &len) != 0 || len > 2 * packed
+				|| fread(payload, 1, len, f) != (size_t) len )
+			break;
+
+		if ( type == FRAME_KEY )
+		{
+			if ( rle_decode(payload, len, board, packed) != 0 )
+				break;
+		}
+		else
+		{
+			if ( rle_decode(payload, len, delta, packed) != 0 )
+				break;
+
+			for ( i=0; i<packed; i++ )
+				board[i] ^= delta[i];
+		}
+
+		if ( gen == generation )
+		{
+			found = 1;
+
+			break;
+		}
+	}
+
+	if ( found )
+	{
+		// Unpack the interior cells into the padded grid
+		for ( i=0; i<s; i++ )
+		{
+			unsigned char *row = board + i * row_bytes;
+
+			for ( j=0; j<s; j++ )
+			{
+				m[(i+1)*p + (j+1)] = (row[j/8] >> (j % 8)) & 1;
+				alives += m[(i+1)*p + (j+1)];
+			}
+		}
+
+		*alive_count = alives;
+	}
+
+	free(board);
+	free(delta);
+	free(payload);
+	fclose(f);
+
+	return ( found ) ? 0 : 1;
+}
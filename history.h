@@ -0,0 +1,51 @@
+/* File:    history.h
+ * Purpose: Streaming run history: every generation is appended to one file as
+ *          a compressed frame, so full evolution records of very long runs
+ *          stay practical for offline analysis.
+ *
+ * Notes:
+ *  1.  Layout: a 24-byte header (magic "GOLH", version, board size, starting
+ *      generation) followed by one frame per generation. A frame is the board
+ *      packed 1 bit per cell (the checkpoint packing), XORed against the
+ *      previous frame's packed board and run-length encoded; every
+ *      HISTORY_KEYFRAME-th frame skips the XOR so replay never has to walk
+ *      the whole file.
+ *  2.  history_finish() appends a keyframe index and a trailer pointing at
+ *      it, so history_seek() can jump to the nearest keyframe at or before
+ *      any generation and replay only the deltas after it. A file cut short
+ *      by a crash has no trailer; seeking then scans the frame headers, which
+ *      skips the payloads and stays cheap.
+ *  3.  The writer keeps only the previous packed board and two scratch
+ *      buffers, so memory stays bounded no matter how long the run is.
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+// History header and trailer constants
+#define HISTORY_MAGIC		"GOLH"
+#define HISTORY_INDEX_MAGIC	"GOLX"
+#define HISTORY_VERSION		1
+#define HISTORY_HEADER_BYTES	24
+
+// Every this many frames a keyframe is written instead of a delta
+#define HISTORY_KEYFRAME	256
+
+// Function that opens path for recording a run of a (s+2)x(s+2) padded grid
+// starting at start_gen; returns 0 on success
+int history_begin(const char *path, long long s, long long start_gen);
+
+// Function that appends one generation's board as a compressed frame;
+// returns 0 on success
+int history_append(const int *m, long long s, long long generation);
+
+// Function that appends the keyframe index and closes the history file;
+// safe to call even if no history was ever opened
+void history_finish();
+
+// Function that loads the board at one recorded generation into a padded
+// grid, replaying the deltas from the nearest keyframe, and fills in the
+// restored population; returns 0 on success
+int history_seek(const char *path, int *m, long long s, long long generation, long long *alive_count);
+
+#endif
@@ -0,0 +1,104 @@
+/* File:    hugealloc.h
+ * Purpose: Board allocator that backs large grids with 2 MB huge pages, so
+ *          sweeps over multi-GB boards stop burning cycles in dTLB misses.
+ *
+ * Notes:
+ *  1.  Above HUGE_ALLOC_THRESHOLD the block is mmap'd: explicit huge pages
+ *      (MAP_HUGETLB) when the system has them reserved, otherwise a normal
+ *      mapping advised to MADV_HUGEPAGE for transparent huge pages. Smaller
+ *      blocks (or failed mappings) fall back to plain calloc.
+ *  2.  Either way the memory comes back zeroed and lazily faulted, so the
+ *      engines' first-touch initialization still decides NUMA placement.
+ *  3.  Header-only (static inline) like prand.h; a page-sized header in
+ *      front of the block records how to free it, so huge_free() needs no
+ *      size argument.
+ */
+
+#ifndef HUGEALLOC_H
+#define HUGEALLOC_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+// 2 MB huge pages; mappings below the threshold are not worth the rounding
+#define HUGE_PAGE_BYTES			(2ULL << 20)
+#define HUGE_ALLOC_THRESHOLD	(8ULL << 20)
+
+// Header in front of every block: [total mapping bytes, how to free]
+#define HUGE_ALLOC_HEADER		4096
+#define HUGE_ALLOC_HEAP_HEADER	(2 * sizeof(size_t))
+#define HUGE_ALLOC_MAPPED		((size_t) 0x4d415050) // "MAPP"
+#define HUGE_ALLOC_HEAP			((size_t) 0x48454150) // "HEAP"
+
+// Function that allocates a zeroed block, huge-page backed when it is large
+static inline void *huge_alloc(size_t bytes)
+{
+	unsigned char	*map = (unsigned char*) MAP_FAILED,
+					*raw;
+	size_t			*hdr,
+					total;
+
+	if ( HUGE_ALLOC_HEADER + bytes >= HUGE_ALLOC_THRESHOLD )
+	{
+		// Round the mapping up to whole huge pages and try explicit huge
+		// pages first, then transparent ones via madvise
+		total = (HUGE_ALLOC_HEADER + bytes + HUGE_PAGE_BYTES - 1) & ~(HUGE_PAGE_BYTES - 1);
+
+#ifdef MAP_HUGETLB
+		map = (unsigned char*) mmap(NULL, total, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+		if ( map == MAP_FAILED )
+		{
+			map = (unsigned char*) mmap(NULL, total, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+#ifdef MADV_HUGEPAGE
+			if ( map != MAP_FAILED )
+				madvise(map, total, MADV_HUGEPAGE);
+#endif
+		}
+
+		if ( map != MAP_FAILED )
+		{
+			// The tag sits right in front of the returned pointer
+			hdr = (size_t*) (map + HUGE_ALLOC_HEADER);
+			hdr[-2] = total;
+			hdr[-1] = HUGE_ALLOC_MAPPED;
+
+			return map + HUGE_ALLOC_HEADER;
+		}
+	}
+
+	// Small boards (or no mapping available): plain zeroed allocation
+	raw = (unsigned char*) calloc(1, HUGE_ALLOC_HEAP_HEADER + bytes);
+
+	if ( raw == NULL )
+		return NULL;
+
+	hdr = (size_t*) raw;
+	hdr[0] = 0;
+	hdr[1] = HUGE_ALLOC_HEAP;
+
+	return raw + HUGE_ALLOC_HEAP_HEADER;
+}
+
+// Function that frees a block allocated with huge_alloc
+static inline void huge_free(void *p)
+{
+	size_t	*hdr;
+
+	if ( p == NULL )
+		return;
+
+	hdr = (size_t*) p;
+
+	if ( hdr[-1] == HUGE_ALLOC_MAPPED )
+		munmap((unsigned char*) p - HUGE_ALLOC_HEADER, hdr[-2]);
+	else
+		free((unsigned char*) p - HUGE_ALLOC_HEAP_HEADER);
+}
+
+#endif
@@ -0,0 +1,41 @@
+/* File:    prand.h
+ * Purpose: Counter-based PRNG for board initialization, replacing the strictly
+ *          serial rand() loop (s*s libc calls with hidden global state).
+ *
+ * Notes:
+ *  1.  prand_cell() is a pure hash of (seed, row, col), so threads and ranks
+ *      can fill their own cells independently, in any order, and every engine
+ *      builds the identical board from the same seed.
+ *  2.  Header-only (static inline) so the MPI engine and the CUDA host code
+ *      can use it without linking another object file.
+ *  3.  The mixer is the splitmix64 finalizer applied twice; like philox-style
+ *      generators the only state is the counter being hashed.
+ */
+
+#ifndef PRAND_H
+#define PRAND_H
+
+#include <stdint.h>
+
+// Function that mixes the bits of x (splitmix64 finalizer, bijective)
+static inline uint64_t prand_mix(uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+	return x ^ (x >> 31);
+}
+
+// Function that returns 0 or 1 for cell (row, col) of a board built from
+// seed; rows and columns are 0-based board coordinates
+static inline int prand_cell(unsigned int seed, long long row, long long col)
+{
+	uint64_t	x = prand_mix((uint64_t) seed);
+
+	x = prand_mix(x ^ ((uint64_t) row << 32) ^ (uint64_t) col);
+
+	return (int) (x & 1ULL);
+}
+
+#endif
@@ -0,0 +1,147 @@
+/* File:    render.c
+ * Purpose: Buffered board renderer shared by the engines (see render.h).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "render.h"
+
+// Longest sequence one cell can emit: a cursor move plus a multibyte glyph
+#define CELL_MAX_BYTES	64
+
+// Renderer state, sized on the first frame
+static char				*frame_buf = NULL;	// Composed frame, flushed in one write
+static unsigned char	*prev_cells = NULL;	// Previous frame, one byte per cell
+static long long		frame_size = -1;
+static int				term_mode = 0;
+
+// Function that appends a string to the frame buffer
+static size_t append(size_t len, const char *str)
+{
+	size_t	n = strlen(str);
+
+	memcpy(&frame_buf[len], str, n);
+
+	return len + n;
+}
+
+// Function that composes a full frame (every cell, one line per row),
+// appending at len
+static size_t compose_full(size_t len, const int *m, long long s, const char *alive_char, const char *dead_char)
+{
+	long long	i,
+				j,
+				p = s+2;
+
+	for ( i=0; i<s; i++ )
+	{
+		for ( j=0; j<s; j++ )
+			len = append(len, m[(i+1)*p + (j+1)] ? alive_char : dead_char);
+
+		len = append(len, "\n");
+	}
+
+	return len;
+}
+
+// Function that composes only the cells that changed since the previous
+// frame, as ANSI cursor moves; runs of adjacent changes need only one move
+static size_t compose_diff(const int *m, long long s, const char *alive_char, const char *dead_char)
+{
+	long long	i,
+				j,
+				p = s+2,
+				cursor_i = -1,
+				cursor_j = -1;
+	size_t		len = 0;
+	char		seq[CELL_MAX_BYTES];
+
+	for ( i=0; i<s; i++ )
+		for ( j=0; j<s; j++ )
+		{
+			unsigned char	cell = (unsigned char) ( m[(i+1)*p + (j+1)] != 0 );
+
+			if ( cell == prev_cells[i*s + j] )
+				continue;
+
+			// Move the cursor unless it is already on this cell
+			if ( i != cursor_i || j != cursor_j )
+			{
+				snprintf(seq, sizeof(seq), "\033[%lld;%lldH", i+1, j+1);
+				len = append(len, seq);
+			}
+
+			len = append(len, cell ? alive_char : dead_char);
+			cursor_i = i;
+			cursor_j = j+1; // Printing advanced the cursor one column
+		}
+
+	// Park the cursor below the board so regular printfs land there
+	snprintf(seq, sizeof(seq), "\033[%lld;1H", s+1);
+	len = append(len, seq);
+
+	return len;
+}
+
+// Function that draws one frame of the padded (s+2)x(s+2) grid
+void render_frame(const int *m, long long s, const char *alive_char, const char *dead_char)
+{
+	long long	i,
+				j,
+				p = s+2;
+	size_t		len;
+	int			first_frame = 0;
+
+	// Size the buffers on the first frame (or if the board size changed)
+	if ( s != frame_size )
+	{
+		render_free();
+
+		frame_buf = (char*) malloc((size_t) s * s * CELL_MAX_BYTES + 64);
+		prev_cells = (unsigned char*) malloc((size_t) s * s);
+
+		if ( frame_buf == NULL || prev_cells == NULL )
+		{
+			render_free();
+
+			return;
+		}
+
+		frame_size = s;
+		term_mode = isatty(fileno(stdout));
+		first_frame = 1;
+	}
+
+	if ( term_mode && first_frame )
+	{
+		// Claim the screen once, then draw the whole board
+		len = append(0, "\033[2J\033[H");
+		len = compose_full(len, m, s, alive_char, dead_char);
+	}
+	else if ( term_mode )
+		len = compose_diff(m, s, alive_char, dead_char);
+	else
+		len = compose_full(0, m, s, alive_char, dead_char);
+
+	// One write per frame
+	fwrite(frame_buf, 1, len, stdout);
+	fflush(stdout);
+
+	// Remember this frame for the next diff
+	for ( i=0; i<s; i++ )
+		for ( j=0; j<s; j++ )
+			prev_cells[i*s + j] = (unsigned char) ( m[(i+1)*p + (j+1)] != 0 );
+}
+
+// Function that releases the renderer's buffers
+void render_free()
+{
+	free(frame_buf);
+	free(prev_cells);
+	frame_buf = NULL;
+	prev_cells = NULL;
+	frame_size = -1;
+}
@@ -0,0 +1,33 @@
+/* File:    render.h
+ * Purpose: Buffered board renderer shared by the engines, replacing the one
+ *          printf-per-cell print_matrix loop (s*s libc calls per frame).
+ *
+ * Notes:
+ *  1.  Every frame is composed into one buffer and flushed with a single
+ *      write, so a frame costs one syscall instead of s*s.
+ *  2.  When stdout is a terminal, frames after the first emit only ANSI
+ *      cursor moves plus the cells that changed since the previous frame,
+ *      so the cost tracks the number of changed cells, not the board size.
+ *  3.  Piped/redirected output keeps the plain full-frame format, so
+ *      diffing two runs still works.
+ */
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Function that draws one frame of the padded (s+2)x(s+2) grid; the first
+// call sizes the internal buffers for s
+void render_frame(const int *m, long long s, const char *alive_char, const char *dead_char);
+
+// Function that releases the renderer's buffers
+void render_free();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,116 @@
+/* File:    rle.c
+ * Purpose: Shared reader for run-length-encoded (RLE) pattern files.
+ *
+ * Notes:
+ *  1.  Understands the common RLE dialect: '#' comment lines, an
+ *      "x = W, y = H" header (a trailing rule is ignored), then runs of
+ *      'b' (dead) / 'o' (alive), '$' for end-of-row and '!' for end.
+ *  2.  Alive cells are streamed into the caller's callback as they are
+ *      decoded, so no intermediate buffer is ever materialized.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "rle.h"
+
+// Function that parses an RLE pattern file; returns 0 on success
+int rle_load(const char *path, long long *width, long long *height, rle_set_cell_fn set_cell, void *ctx)
+{
+	FILE		*f;
+	char		line[4096];
+	long long	row = 0,
+				col = 0,
+				run = 0;
+	int			c,
+				got_header = 0;
+
+	f = fopen(path, "r");
+
+	if ( f == NULL )
+		return 1;
+
+	*width = 0;
+	*height = 0;
+
+	// Skip comments and read the header line
+	while ( !got_header && fgets(line, sizeof(line), f) != NULL )
+	{
+		if ( line[0] == '#' )
+			continue;
+
+		if ( sscanf(line, "x = %lld, y = %lld", width, height) == 2 )
+			got_header = 1;
+		else
+		{
+			fclose(f);
+
+			return 1;
+		}
+	}
+
+	if ( !got_header )
+	{
+		fclose(f);
+
+		return 1;
+	}
+
+	// Stream the encoded cells
+	while ( (c = fgetc(f)) != EOF )
+	{
+		if ( isspace(c) )
+			continue;
+
+		if ( isdigit(c) )
+		{
+			run = run * 10 + (c - '0');
+
+			continue;
+		}
+
+		if ( run == 0 )
+			run = 1;
+
+		switch ( c )
+		{
+			case 'b':
+			case '.':
+				// Dead run: just advance
+				col += run;
+				break;
+
+			case 'o':
+			case 'O':
+				// Alive run: stream each cell to the caller
+				while ( run-- > 0 )
+					set_cell(ctx, row, col++);
+				break;
+
+			case '$':
+				// End of row(s)
+				row += run;
+				col = 0;
+				break;
+
+			case '!':
+				// End of pattern
+				fclose(f);
+
+				return 0;
+
+			default:
+				// Unknown tag
+				fclose(f);
+
+				return 1;
+		}
+
+		run = 0;
+	}
+
+	fclose(f);
+
+	return 0;
+}
@@ -0,0 +1,17 @@
+/* File:    rle.h
+ * Purpose: Shared reader for run-length-encoded (RLE) pattern files, used by
+ *          every engine to start from a real pattern instead of a random fill.
+ */
+
+#ifndef RLE_H
+#define RLE_H
+
+// Callback invoked once for every alive cell in the pattern (0-based coords)
+typedef void (*rle_set_cell_fn)(void *ctx, long long row, long long col);
+
+// Function that parses an RLE pattern file, streaming alive cells straight
+// into the callback (no intermediate text buffer); fills in the pattern
+// dimensions from the header and returns 0 on success
+int rle_load(const char *path, long long *width, long long *height, rle_set_cell_fn set_cell, void *ctx);
+
+#endif
@@ -0,0 +1,63 @@
+/* File:    verify.h
+ * Purpose: Board checksums shared by the engines' --verify mode, so optimized
+ *          paths can be compared against the reference rules per generation
+ *          instead of only by the final population (which can collide).
+ *
+ * Notes:
+ *  1.  The hash is an XOR of position-salted 64-cell word mixes, so it can be
+ *      maintained incrementally while a board is written (in any block order)
+ *      or computed from a finished board, with identical results.
+ *  2.  --verify runs print one "VERIFY <generation> <alives> <hash>" line per
+ *      generation; verify.sh diffs those streams between two engines.
+ */
+
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include "prand.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Function that hashes columns j0..j1 of one written row (1-based interior
+// coordinates of a padded grid row); j0-1 must be a multiple of 64 so the
+// word grouping lines up across callers
+static inline unsigned long long verify_row_hash(const int *row, long long i, long long j0, long long j1)
+{
+	unsigned long long	acc = 0,
+						w;
+	long long			g,
+						j;
+
+	for ( g=j0; g<=j1; g+=64 )
+	{
+		w = 0;
+
+		for ( j=g; j<=j1 && j<g+64; j++ )
+			w = (w << 1) | (unsigned long long) row[j];
+
+		acc ^= prand_mix(w ^ ((unsigned long long) i << 32) ^ (unsigned long long) (g >> 6));
+	}
+
+	return acc;
+}
+
+// Function that hashes a whole padded (s+2)x(s+2) grid
+static inline unsigned long long verify_board_hash(const int *m, long long s)
+{
+	unsigned long long	h = 0;
+	long long			i,
+						p = s+2;
+
+	for ( i=1; i<=s; i++ )
+		h ^= verify_row_hash(&m[i*p], i, 1, s);
+
+	return h;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
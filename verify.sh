@@ -0,0 +1,104 @@
+#!/bin/sh
+# Cross-engine verification harness: every engine must produce the same board
+# as the serial reference, generation by generation, not just the same final
+# population (which can collide). Each engine's --verify mode prints one
+# "VERIFY <generation> <alives> <hash>" line per generation; the streams are
+# diffed in lockstep against the serial engine's, so the first diverging
+# generation is visible directly in the diff.
+#
+# Usage: ./verify.sh   (binaries are built by 'make'; exits nonzero on FAIL)
+
+SEED=42
+SIZE="${SIZE:-130}"
+GENERATIONS="${GENERATIONS:-20}"
+THREADS="${THREADS:-2}"
+
+failures=0
+
+# Report one check; any FAIL makes the script exit nonzero at the end
+report()
+{
+	if [ "$1" -eq 0 ]; then
+		echo "PASS  $2"
+	else
+		echo "FAIL  $2"
+		failures=$((failures + 1))
+	fi
+}
+
+# Run a command and keep only its VERIFY lines
+stream()
+{
+	"$@" 2> /dev/null | grep -o 'VERIFY.*'
+}
+
+ref=/tmp/verify_ref.$$
+ref_mpi=/tmp/verify_ref_mpi.$$
+run=/tmp/verify_run.$$
+
+echo "Reference: ./game $SIZE $GENERATIONS $SEED --verify"
+stream ./game "$SIZE" "$GENERATIONS" "$SEED" --verify > "$ref"
+
+if [ ! -s "$ref" ]; then
+	echo "FAIL  reference run produced no VERIFY lines"
+	rm -f "$ref"
+	exit 1
+fi
+
+# Lockstep comparison: every other engine against the serial stream
+for cmd in \
+	"./game_omp $SIZE $GENERATIONS $THREADS $SEED --verify" \
+	"./game_pthread $SIZE $GENERATIONS $THREADS $SEED --verify" \
+	"./game_sparse $SIZE $GENERATIONS $THREADS $SEED --verify" \
+	"./game_bit $SIZE $GENERATIONS $SEED --verify" \
+	"./game_tmpl $SIZE $GENERATIONS $SEED --verify" \
+	"./game_unified $SIZE $GENERATIONS $THREADS $SEED --engine=serial --verify" \
+	"./game_unified $SIZE $GENERATIONS $THREADS $SEED --engine=omp --verify" \
+	"./game_unified $SIZE $GENERATIONS $THREADS $SEED --engine=pthread --verify"
+do
+	set -- $cmd
+	[ -x "$1" ] || continue
+	stream "$@" > "$run"
+	diff "$ref" "$run" > /dev/null 2>&1
+	report $? "$cmd"
+done
+
+# The MPI engine uses a dead border instead of a torus, so its reference is
+# game_tmpl --bounded (same topology). Its VERIFY lines carry no board hash:
+# the rank tiles split columns on byte boundaries, which never line up with
+# the 64-cell hash groups of verify.h, so only the populations are compared.
+if [ -x MPI/game_mpi ] && [ -x ./game_tmpl ] && command -v mpirun > /dev/null 2>&1; then
+	stream ./game_tmpl "$SIZE" "$GENERATIONS" "$SEED" --bounded --verify | awk '{ print $1, $2, $3 }' > "$ref_mpi"
+	# --oversubscribe: correctness does not care about rank placement, so the
+	# check still runs on machines with fewer cores than ranks
+	stream mpirun --oversubscribe -np "$THREADS" MPI/game_mpi "$SIZE" "$GENERATIONS" "$SEED" --verify > "$run"
+	diff "$ref_mpi" "$run" > /dev/null 2>&1
+	report $? "mpirun -np $THREADS MPI/game_mpi $SIZE $GENERATIONS $SEED (populations vs game_tmpl --bounded)"
+fi
+
+# Temporal blocking must land on the same final board; one of its passes
+# covers several generations, so only the last line is comparable
+stream ./game "$SIZE" "$GENERATIONS" "$SEED" --tblock 4 --verify | tail -n 1 > "$run"
+tail -n 1 "$ref" | diff - "$run" > /dev/null 2>&1
+report $? "./game $SIZE $GENERATIONS $SEED --tblock 4 (final board)"
+
+# Known patterns: population after a fixed number of generations
+# (pattern file, generations, expected population)
+while read -r pattern gens expected; do
+	got=$(stream ./game 64 "$gens" 0 "patterns/$pattern" --verify | tail -n 1 | awk '{ print $3 }')
+	[ "$got" = "$expected" ]
+	report $? "patterns/$pattern after $gens generations ($got alive, expected $expected)"
+done <<EOF
+blinker.rle 21 3
+glider.rle 20 5
+rpentomino.rle 100 121
+EOF
+
+rm -f "$ref" "$ref_mpi" "$run"
+
+if [ "$failures" -gt 0 ]; then
+	echo "$failures check(s) failed"
+	exit 1
+fi
+
+echo "All checks passed"